@@ -0,0 +1,42 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __AUTODET_H
+#define __AUTODET_H
+
+// Prototypes
+
+// bracket the main view render with these, the time between them is what gets budgeted
+void autodet_frame_start(void);
+void autodet_frame_end(void);
+void autodet_reset(void);
+
+// call once a frame is done, makes any res change that has to wait for that
+void autodet_between_frames(void);
+
+// what the player actually picked, regardless of where we have pushed things
+int autodet_user_detail(void);
+bool autodet_user_half_res(void);
+
+// Globals
+
+extern int autodet_budget;        // target render time in ms, 0 is off
+extern uchar autodet_half_res_ok; // can we drop to half res when all else fails
+
+#endif // __AUTODET_H
@@ -166,6 +166,11 @@ typedef void (*AnimlistCB)(ObjID id, void *user_data);
 ObjID do_special_effect(ObjID owner, ubyte effect, ubyte start, ObjID obj, short location);
 ObjID do_special_effect_location(ObjID owner, ubyte effect, ubyte start, ObjLoc *loc, short location);
 void advance_animations(void);
+void anim_catch_up(ObjID id);
+void anim_lazy_reset(void);
+void animtext_catch_up(int g);
+void animtext_catch_up_all(void);
+extern uchar animtext_changed;
 errtype add_obj_to_animlist(ObjID id, uchar repeat, uchar reverse, uchar cycle, short speed, int cb_id, void *user_data,
                             short cbtype);
 errtype remove_obj_from_animlist(ObjID id);
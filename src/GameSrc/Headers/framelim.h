@@ -0,0 +1,40 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/*
+ * framelim.h
+ *
+ * frame rate cap for the main loop
+ */
+
+#ifndef __FRAMELIM_H
+#define __FRAMELIM_H
+
+// Prototypes
+
+// call once a frame, after the frame has been shown; waits out the rest of the frame
+void framelim_frame_end(void);
+
+// Globals
+
+extern int framelim_fps;      // frame rate cap, 0 is off
+extern int framelim_idle_fps; // cap when we're unfocused, minimized or paused, 0 is off
+extern uchar framelim_stats;  // log frame time and jitter every so often
+extern void (*framelim_report_func)(void); // called after each of those, for other counts to go out with it
+
+#endif // __FRAMELIM_H
@@ -77,11 +77,16 @@ int fr_pts_resize(int x, int y);
 int fr_pts_freemem(void);
 int fr_pts_update(int y, int lx, int rx);
 int fr_pts_setup(int pt_code); // must call before update
+int fr_pts_cache_stats(void);
+#ifdef __3D_H
+g3s_phandle fr_pts_cache_slot(int cx, int cy, fix dy, int mod, fix arg, uchar *hit);
+#endif
 
 #ifndef __FRPTS_SRC
 #ifdef __3D_H
 extern g3s_phandle *_fr_ptbase, *_fr_ptnext;
 #endif // __3D_H
+extern int fr_pt_cache_hits, fr_pt_cache_misses;
 #endif // __FRPTS_SRC
 
 //======== From frclip.c
@@ -94,6 +99,17 @@ int fr_clip_cone(void);
 int fr_clip_tile(void);
 int fr_clip_freemem(void);
 
+//======== From frpvs.c
+// per tile potentially visible sets, built when a map is compiled
+int fr_pvs_resize(int x, int y);
+void fr_pvs_flush(void);
+void fr_pvs_map_changed(fmp *fmptr, int llx, int lly, int ulx, int uly);
+int fr_pvs_prune(void);
+
+#ifndef __FRPVS_SRC
+extern uchar fr_pvs_on;
+#endif
+
 //======== From frtables.c
 // setup and integrity test various renderer data tables
 int fr_tables_build(void);
@@ -114,6 +130,7 @@ void fr_draw_tile(void);
 void fr_terr_frame_start(void);
 void fr_terr_frame_end(void);
 void _fr_facelet_init(void);
+int fr_light_cache_stats(void);
 #ifdef __3D_H
 int _fr_do_light(g3s_phandle work, int hgt_code);
 #endif
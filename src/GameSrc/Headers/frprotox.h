@@ -102,6 +102,9 @@ void fr_compile_restart(fmp *fm);
 int fr_rend(frc *view);
 ushort fr_get_at(frc *view, int x, int y, uchar transp);
 
+//======== From frterr.c
+void fr_light_changed(void); // call when anything the terrain lighting reads changes
+
 //======== From frutil.c
 char *fr_get_frame_rate(void);
 
@@ -59,6 +59,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define MFD_INCREMENTAL    0x02 // Uses standard MFD background
 #define MFD_CHANGEBIT_FULL 0x04
 #define MFD_NOSAVEREST     0x08 // don't save/restore me.
+#define MFD_POLLS          0x10 // its expose notifies it again, so one skipped as unchanged gets that done for it
 
 // Flags for Expose Control
 #define MFD_EXPOSE      0x01
@@ -155,6 +155,9 @@ typedef struct _mfd_func {
     long last;   // Timestamp for incremental
     int handler_count;
     MFDhandler handlers[NUM_MFD_HANDLERS];
+    // Hashes into hash everything a partial expose draws from, if the func
+    // can say, so one that would draw the same thing can be skipped.
+    ulong (*state)(MFD *mfd, ulong hash);
 } MFD_Func;
 
 extern void init_mfd_funcs();
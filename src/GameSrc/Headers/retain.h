@@ -0,0 +1,67 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/*
+ * retain.h
+ *
+ * retained drawing for interface panels
+ */
+
+#ifndef __RETAIN_H
+#define __RETAIN_H
+
+// Typedefs
+
+// A panel whose last drawing is still up, wherever it lives (the screen, or
+// an offscreen canvas that gets blitted), along with a hash of everything
+// that went into drawing it.
+typedef struct {
+    char *name;
+    ulong hash;       // state that drew what's up now
+    uchar valid;      // FALSE when what's up can't be vouched for
+    uchar registered; // on the list retain_invalidate_all() and retain_report() walk
+    ulong draws;      // since the last report
+    ulong skips;
+} retained_panel;
+
+#define RETAIN_PANEL(name) \
+    { name, 0, FALSE, FALSE, 0, 0 }
+
+#define RETAIN_HASH_START 2166136261u
+
+// Prototypes
+
+// fold len bytes at p into hash h
+ulong retain_hash(ulong h, void *p, int len);
+#define retain_hash_var(h, v) retain_hash(h, &(v), sizeof(v))
+
+// is hash different from what drew the panel last; counts a draw if so, and
+// then the caller must draw it, or a skip if not
+uchar retain_check(retained_panel *p, ulong hash);
+
+// the panel was drawn for reasons no hash covers, or drawn over
+void retain_drew(retained_panel *p);
+
+// nothing that's up can be vouched for any more: the screen mode changed, or
+// the whole screen is being redrawn
+void retain_invalidate_all(void);
+
+// log how often each panel drew since the last time
+void retain_report(void);
+
+#endif // __RETAIN_H
@@ -63,7 +63,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "textmaps.h"
 extern uchar tmap_static_mem[NUM_STATIC_TMAPS * SIZE_STATIC_TMAP];
 #ifdef SVGA_CUTSCENES
-extern uchar tmap_big_buffer[NUM_STATIC_TMAPS * SIZE_BIG_TMAP];
+extern uchar *tmap_big_buffer; // made by load_textures, tmap_big_budget 128s
 #endif
 
 #include "objects.h"
@@ -54,6 +54,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 // Prototypes
 void select_current_target(ObjID id, uchar force_mfd);
 void mfd_target_expose(MFD *m, ubyte control);
+errtype mfd_target_init(MFD_Func *f);
+ulong mfd_target_state(MFD *m, ulong hash);
 uchar mfd_target_handler(MFD *m, uiEvent *e);
 void toggle_current_target();
 
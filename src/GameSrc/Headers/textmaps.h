@@ -79,6 +79,12 @@ They are hardwired to avoid needless dependencies.
 #define SIZE_STATIC_TMAP ((64 * 64) + (32 * 32) + (16 * 16))
 #define SIZE_BIG_TMAP (128 * 128)
 
+// how many 128s the pool keeps, the endgame shodan overlay borrows the pool's
+// memory and needs 320x200 of it, so it is never made smaller than TMAP_BIG_MIN
+#define TMAP_BIG_MIN 4
+#define TMAP_BIG_DEFAULT 24
+extern int tmap_big_budget;
+
 typedef struct {
     // These are indices into the texture_bitmaps array
     // Note that for animating textures, the entry and the
@@ -122,6 +128,9 @@ typedef struct {
 
 // Prototypes
 void load_textures();
+void textures_prefetch(void);
+void textures_lend_buffers(void);
+void textures_stats(void);
 errtype load_alternate_textures();
 errtype bitmap_array_unload(int *num_bitmaps, grs_bitmap *arr[]);
 errtype Init_Lighting(void);
@@ -39,3 +39,4 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 extern uchar view360_active_contexts[NUM_360_CONTEXTS]; // which contexts should actually draw
 extern uchar view360_context_views[NUM_360_CONTEXTS];   // which view is being shown by a given context
+extern uchar view360_stagger; // render one view a frame in turn, rather than all of them
@@ -41,6 +41,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 // cyborg                - brightbrownx
 // doors                 - maize?
 
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 
@@ -619,82 +620,25 @@ void amap_pixratio_set(fix ratio) {
 }
 #endif
 
-void amap_draw(curAMap *amptr, int expose) {
-    int xc, yc, xm, ym, drw, static_drw, cv; // loop control, so on
-    int zeroscrx, zeroscry, init_yc;         // x and y screen coordinate for 0,0 of map
+// draw hazard/elevator floor colors, then walls, for the tiles from xbase,yc
+// up to max_xc,max_yc, whose drw masks are in drws
+static void amap_floors_and_walls(curAMap *amptr, uchar *drws, int xbase, int yc, int max_xc, int max_yc, int crnr_x,
+                                  int crnr_y, ushort sensor_x, ushort sensor_y) {
+    int xc, xm, ym, drw, cv, mt, init_yc = yc;
     int tsize = 1 << amptr->zoom;
 #ifdef AMAP_SENS_TILEBOUND
     int facemask;
 #endif
-    int mt, pass;
-    ushort sensor_x, sensor_y;
-    MapElem *curmp = MAP_GET_XY(0, 0);
-    fix amrh, amrw;
-    int max_xc, max_yc, xbase, crnr_x, crnr_y; // am w and h radius
-    MapElem *mapybase, *init_mapybase;
-
-    if (amptr->flags & AMAP_TRACK_OBJ) {
-        amptr->xf = objs[amptr->obj_to_follow].loc.x << 8;
-        amptr->yf = fix_make(MAP_YSIZE, 0) - 1 - (objs[amptr->obj_to_follow].loc.y << 8);
-    }
-
-    amptr->lw = grd_bm.w;
-    amptr->lh = grd_bm.h;
-
-    zeroscrx = (grd_bm.w >> 1) - fix_int(amptr->xf << amptr->zoom);
-    zeroscry = pix_to_coor(grd_bm.h >> 1) - fix_int(amptr->yf << amptr->zoom);
-    zeroscry = zeroscry + (MAP_YSIZE << amptr->zoom);
-    if (amptr->sensor_obj != OBJ_NULL) {
-        sensor_x = objs[amptr->sensor_obj].loc.x;
-        sensor_y = objs[amptr->sensor_obj].loc.y;
-    } else
-        sensor_x = sensor_y = 0;
-
-    amrw = (grd_bm.w << 15) >> amptr->zoom;              // w radius of amap, in fix point tiles
-    amrh = pix_to_coor((grd_bm.h << 15) >> amptr->zoom); // h radius of amap, in fix point tiles
-    xc = fix_int(amptr->xf - amrw);
-    max_xc = 1 + fix_int(amptr->xf + amrw);
-    yc = MAP_YSIZE - (1 + fix_int(amptr->yf + amrh));
-    max_yc = MAP_YSIZE - fix_int(amptr->yf - amrh);
-    if (xc < 0)
-        xc = 0;
-    if (max_xc >= MAP_XSIZE)
-        max_xc = MAP_XSIZE - 1;
-    if (yc < 0)
-        yc = 0;
-    if (max_yc >= MAP_XSIZE)
-        max_yc = MAP_XSIZE - 1;
-    xbase = xc;
-    crnr_x = zeroscrx + (xc << amptr->zoom);
-    crnr_y = zeroscry - (yc << amptr->zoom);
-    mapybase = curmp + (yc * MAP_XSIZE) + xc;
-
-    //   mprintf("rect %d %d and %d %d, crnr %d %d from rw and rh %.2q %.2q cnt %.2q
-    //   %.2q....\n",xc,yc,max_xc,max_yc,crnr_x,crnr_y,amrw,amrh,amptr->xf,amptr->yf);
-
-    //   mprintf("Zero at %d %d...\n",zeroscrx,zeroscry);
+    MapElem *curmp, *mapybase = MAP_GET_XY(xbase, yc);
+    MapElem *init_mapybase = mapybase;
+    uchar *d;
 
-    if (expose)
-        gr_clear(0xFF);
-    static_drw = 0;
-    if (amptr->flags & AMAP_SHOW_ALL)
-        static_drw |= DRAW_MASK_FULL | DRAW_MASK_TERR;
-    else if (amptr->flags & AMAP_SHOW_FLR)
-        static_drw |= DRAW_MASK_TERR;
-    if (amptr->flags & AMAP_SHOW_SENS)
-        static_drw |= DRAW_MASK_SENS;
     gr_set_fcolor(GREEN_BASE + 2);
-    init_mapybase = mapybase;
-    init_yc = yc;
 
     // draw hazard/elevator floor colors BEFORE drawing walls.
-    for (ym = crnr_y; yc < max_yc; yc++, ym -= tsize, mapybase += MAP_XSIZE)
+    for (ym = crnr_y, d = drws; yc < max_yc; yc++, ym -= tsize, mapybase += MAP_XSIZE)
         for (curmp = mapybase, xc = xbase, xm = crnr_x; xc < max_xc; xc++, xm += tsize, curmp++) {
-            drw = static_drw;
-            if (me_bits_seen(curmp))
-                drw |= DRAW_MASK_SEEN;
-            if (fix_fast_pyth_dist((xc << 8) + 0x80 - sensor_x, (yc << 8) + 0x80 - sensor_y) < amptr->sensor_rad)
-                drw |= DRAW_MASK_RAD;
+            drw = *d++;
 
             if (((mt = me_tiletype(curmp)) != TILE_SOLID) && (drw != 0)) {
                 if (drw & (DRAW_MASK_SEEN | DRAW_MASK_RAD)) {
@@ -719,13 +663,9 @@ void amap_draw(curAMap *amptr, int expose) {
     mapybase = init_mapybase;
     yc = init_yc;
     // now draw walls and such
-    for (ym = crnr_y; yc < max_yc; yc++, ym -= tsize, mapybase += MAP_XSIZE)
+    for (ym = crnr_y, d = drws; yc < max_yc; yc++, ym -= tsize, mapybase += MAP_XSIZE)
         for (curmp = mapybase, xc = xbase, xm = crnr_x; xc < max_xc; xc++, xm += tsize, curmp++) {
-            drw = static_drw;
-            if (me_bits_seen(curmp))
-                drw |= DRAW_MASK_SEEN;
-            if (fix_fast_pyth_dist((xc << 8) + 0x80 - sensor_x, (yc << 8) + 0x80 - sensor_y) < amptr->sensor_rad)
-                drw |= DRAW_MASK_RAD;
+            drw = *d++;
 
             if ((me_tiletype(curmp) != TILE_SOLID) && (drw != 0)) {
                 int csbits = me_clearsolid(curmp), loop;
@@ -811,18 +751,312 @@ void amap_draw(curAMap *amptr, int expose) {
             }
 #endif
         } // for y loop
+}
+
+// Everything the floor and wall passes look at for one tile.  The tiles
+// around the ones drawn count too, since walls depend on the heights on both
+// sides.
+typedef struct {
+    uchar tiletype, flr_rotnhgt, ceil_rotnhgt, param;
+    uchar clearsolid, flag2, seen, drw;
+} amap_tile_key;
+
+// The floor and wall passes are most of the work in amap_draw, and they only
+// change when the map does, so they are drawn into a bitmap that's kept for
+// each automap and put down over whatever is there, with the objects and the
+// player drawn on top fresh each frame.  The bitmap is good as long as the
+// automap is the same size, zoom and offset and every tile key matches.
+#define AMAP_BASE_CNT 3
+
+typedef struct {
+    curAMap *amptr; // whose it is
+    grs_bitmap bm;  // floors and walls, 0 where there's nothing
+    grs_bitmap sub; // the part of bm with anything in it
+    short l, t;     // where sub is in bm
+    uint *runs;     // sub's opaque runs, so putting it down is just copies
+    int zeroscrx, zeroscry;
+    int at_x, at_y; // zeroscrx,zeroscry last frame, whether drawn or not
+    fix pixratio;
+    ushort flags; // the ones the two passes care about
+    uchar zoom, zerogbio;
+    short kx, ky, kw, kh; // tiles covered by key
+    amap_tile_key *key;
+    int key_size;
+    uint last_use;
+} amap_base;
+
+#define AMAP_BASE_FLAGS (AMAP_SHOW_ALL | AMAP_SHOW_FLR | AMAP_SHOW_SENS | AMAP_SHOW_HAZ)
+
+static amap_base amap_bases[AMAP_BASE_CNT];
+static uint amap_base_clock;
+static amap_tile_key *amap_key_scratch;
+static int amap_key_size;
+static uchar *amap_drws; // this frame's drw mask for each tile drawn
+static int amap_drws_size;
+
+// make the key for tiles kx,ky to kx+kw,ky+kh, of which xbase,yc to max_xc,max_yc
+// are drawn with the masks in drws
+static amap_tile_key *amap_make_key(uchar *drws, int kx, int ky, int kw, int kh, int xbase, int yc, int max_xc,
+                                    int max_yc) {
+    amap_tile_key *k;
+    MapElem *mp;
+    int x, y, drw;
+
+    if (kw * kh > amap_key_size) {
+        free(amap_key_scratch);
+        amap_key_scratch = (amap_tile_key *)malloc(kw * kh * sizeof(amap_tile_key));
+        amap_key_size = (amap_key_scratch != NULL) ? kw * kh : 0;
+        if (amap_key_scratch == NULL)
+            return NULL;
+    }
+    for (y = ky, k = amap_key_scratch; y < ky + kh; y++) {
+        mp = MAP_GET_XY(kx, y);
+        for (x = kx; x < kx + kw; x++, k++, mp++) {
+            k->tiletype = me_tiletype(mp);
+            k->flr_rotnhgt = mp->flr_rotnhgt;
+            k->ceil_rotnhgt = mp->ceil_rotnhgt;
+            k->param = mp->param;
+            k->clearsolid = me_clearsolid(mp);
+            k->flag2 = me_flag2(mp);
+            k->seen = me_bits_seen(mp);
+            k->drw = 0;
+            if ((x >= xbase) && (x < max_xc) && (y >= yc) && (y < max_yc)) {
+                drw = drws[(y - yc) * (max_xc - xbase) + (x - xbase)];
+                // being near the sensor only shows the floor of a tile not
+                // seen yet, and only an elevator or hazard floor at that, so
+                // leave it out otherwise or the bitmap goes every step
+                if (!(drw & DRAW_MASK_SEEN) &&
+                    ((me_bits_music(mp) == ELEVATOR_ZONE) || me_hazard_bio_x(mp) || me_hazard_rad_x(mp)))
+                    k->drw = drw;
+                else
+                    k->drw = drw & ~DRAW_MASK_RAD;
+            }
+        }
+    }
+    return amap_key_scratch;
+}
+
+// the floors and walls bitmap for amptr as it would be drawn now, or NULL
+// if they have to be drawn straight to the canvas
+static amap_base *amap_get_base(curAMap *amptr, uchar *drws, int xbase, int yc, int max_xc, int max_yc, int crnr_x,
+                                int crnr_y, int zeroscrx, int zeroscry, ushort sensor_x, ushort sensor_y) {
+    amap_base *b, *use = NULL;
+    amap_tile_key *key;
+    grs_canvas cnv;
+    uchar *bits, *p;
+    int i, x, y, l, r, t, bt, kx, ky, kw, kh;
+    ushort flags = amptr->flags & AMAP_BASE_FLAGS;
+    uchar zerogbio = (level_gamedata.hazard.zerogbio != 0);
+
+    if ((grd_bm.type != BMT_FLAT8) || (max_xc <= xbase) || (max_yc <= yc))
+        return NULL;
+    kx = (xbase > 0) ? xbase - 1 : 0;
+    ky = (yc > 0) ? yc - 1 : 0;
+    kw = ((max_xc < MAP_XSIZE) ? max_xc + 1 : MAP_XSIZE) - kx;
+    kh = ((max_yc < MAP_YSIZE) ? max_yc + 1 : MAP_YSIZE) - ky;
+
+    for (i = 0; i < AMAP_BASE_CNT; i++) {
+        b = &amap_bases[i];
+        if (b->amptr == amptr) {
+            use = b;
+            break;
+        }
+        if ((use == NULL) || (b->last_use < use->last_use))
+            use = b;
+    }
+    use->last_use = ++amap_base_clock;
+    // while it's scrolling every frame would be a new bitmap, so don't
+    // bother until it holds still
+    if ((use->amptr == amptr) && ((use->at_x != zeroscrx) || (use->at_y != zeroscry))) {
+        use->at_x = zeroscrx;
+        use->at_y = zeroscry;
+        return NULL;
+    }
+    if ((key = amap_make_key(drws, kx, ky, kw, kh, xbase, yc, max_xc, max_yc)) == NULL)
+        return NULL;
+    if ((use->amptr == amptr) && (use->bm.w == grd_bm.w) && (use->bm.h == grd_bm.h) && (use->zoom == amptr->zoom) &&
+        (use->zeroscrx == zeroscrx) && (use->zeroscry == zeroscry) && (use->pixratio == pixratio_yx) &&
+        (use->flags == flags) && (use->zerogbio == zerogbio) && (use->kx == kx) && (use->ky == ky) &&
+        (use->kw == kw) && (use->kh == kh) && (memcmp(use->key, key, kw * kh * sizeof(amap_tile_key)) == 0))
+        return use;
+
+    // out of date, draw it again
+    if ((use->bm.bits == NULL) || (use->bm.w != grd_bm.w) || (use->bm.h != grd_bm.h)) {
+        free(use->bm.bits);
+        use->amptr = NULL;
+        if ((bits = (uchar *)malloc(grd_bm.w * grd_bm.h)) == NULL) {
+            use->bm.bits = NULL;
+            return NULL;
+        }
+        gr_init_bm(&use->bm, bits, BMT_FLAT8, BMF_TRANS, grd_bm.w, grd_bm.h);
+    }
+    if (use->key_size < kw * kh) {
+        free(use->key);
+        use->amptr = NULL;
+        if ((use->key = (amap_tile_key *)malloc(kw * kh * sizeof(amap_tile_key))) == NULL) {
+            use->key_size = 0;
+            return NULL;
+        }
+        use->key_size = kw * kh;
+    }
+    use->amptr = amptr;
+    use->zoom = amptr->zoom;
+    use->zeroscrx = zeroscrx;
+    use->zeroscry = zeroscry;
+    use->at_x = zeroscrx;
+    use->at_y = zeroscry;
+    use->pixratio = pixratio_yx;
+    use->flags = flags;
+    use->zerogbio = zerogbio;
+    use->kx = kx;
+    use->ky = ky;
+    use->kw = kw;
+    use->kh = kh;
+    memcpy(use->key, key, kw * kh * sizeof(amap_tile_key));
+
+    gr_make_canvas(&use->bm, &cnv);
+    gr_push_canvas(&cnv);
+    gr_clear(0);
+    amap_floors_and_walls(amptr, drws, xbase, yc, max_xc, max_yc, crnr_x, crnr_y, sensor_x, sensor_y);
+    gr_pop_canvas();
+
+    // zoomed out the map is a small part of the canvas, only put down that part
+    l = use->bm.w;
+    r = t = bt = -1;
+    for (y = 0, p = use->bm.bits; y < use->bm.h; y++, p += use->bm.row) {
+        for (x = 0; (x < use->bm.w) && (p[x] == 0); x++)
+            ;
+        if (x == use->bm.w)
+            continue;
+        if (t < 0)
+            t = y;
+        bt = y;
+        if (x < l)
+            l = x;
+        for (x = use->bm.w - 1; p[x] == 0; x--)
+            ;
+        if (x > r)
+            r = x;
+    }
+    if (t < 0)
+        l = r = t = bt = 0; // nothing at all
+    else {
+        r++;
+        bt++;
+    }
+    gr_init_sub_bm(&use->bm, &use->sub, l, t, r - l, bt - t);
+    use->l = l;
+    use->t = t;
+    free(use->runs);
+    if ((use->runs = (uint *)malloc(gr_sprite_runs_size(&use->sub))) != NULL)
+        gr_sprite_runs_make(&use->sub, use->runs);
+    return use;
+}
+
+void amap_draw(curAMap *amptr, int expose) {
+    int xc, yc, xm, ym, drw, static_drw;     // loop control, so on
+    int zeroscrx, zeroscry, init_yc;         // x and y screen coordinate for 0,0 of map
+    int tsize = 1 << amptr->zoom;
+    int pass;
+    ushort sensor_x, sensor_y;
+    MapElem *curmp = MAP_GET_XY(0, 0);
+    fix amrh, amrw;
+    int max_xc, max_yc, xbase, crnr_x, crnr_y; // am w and h radius
+    MapElem *mapybase, *init_mapybase;
+    amap_base *base;
+    uchar *d;
+
+    if (amptr->flags & AMAP_TRACK_OBJ) {
+        amptr->xf = objs[amptr->obj_to_follow].loc.x << 8;
+        amptr->yf = fix_make(MAP_YSIZE, 0) - 1 - (objs[amptr->obj_to_follow].loc.y << 8);
+    }
+
+    amptr->lw = grd_bm.w;
+    amptr->lh = grd_bm.h;
+
+    zeroscrx = (grd_bm.w >> 1) - fix_int(amptr->xf << amptr->zoom);
+    zeroscry = pix_to_coor(grd_bm.h >> 1) - fix_int(amptr->yf << amptr->zoom);
+    zeroscry = zeroscry + (MAP_YSIZE << amptr->zoom);
+    if (amptr->sensor_obj != OBJ_NULL) {
+        sensor_x = objs[amptr->sensor_obj].loc.x;
+        sensor_y = objs[amptr->sensor_obj].loc.y;
+    } else
+        sensor_x = sensor_y = 0;
+
+    amrw = (grd_bm.w << 15) >> amptr->zoom;              // w radius of amap, in fix point tiles
+    amrh = pix_to_coor((grd_bm.h << 15) >> amptr->zoom); // h radius of amap, in fix point tiles
+    xc = fix_int(amptr->xf - amrw);
+    max_xc = 1 + fix_int(amptr->xf + amrw);
+    yc = MAP_YSIZE - (1 + fix_int(amptr->yf + amrh));
+    max_yc = MAP_YSIZE - fix_int(amptr->yf - amrh);
+    if (xc < 0)
+        xc = 0;
+    if (max_xc >= MAP_XSIZE)
+        max_xc = MAP_XSIZE - 1;
+    if (yc < 0)
+        yc = 0;
+    if (max_yc >= MAP_XSIZE)
+        max_yc = MAP_XSIZE - 1;
+    xbase = xc;
+    crnr_x = zeroscrx + (xc << amptr->zoom);
+    crnr_y = zeroscry - (yc << amptr->zoom);
+    mapybase = curmp + (yc * MAP_XSIZE) + xc;
+
+    //   mprintf("rect %d %d and %d %d, crnr %d %d from rw and rh %.2q %.2q cnt %.2q
+    //   %.2q....\n",xc,yc,max_xc,max_yc,crnr_x,crnr_y,amrw,amrh,amptr->xf,amptr->yf);
+
+    //   mprintf("Zero at %d %d...\n",zeroscrx,zeroscry);
+
+    if (expose)
+        gr_clear(0xFF);
+    static_drw = 0;
+    if (amptr->flags & AMAP_SHOW_ALL)
+        static_drw |= DRAW_MASK_FULL | DRAW_MASK_TERR;
+    else if (amptr->flags & AMAP_SHOW_FLR)
+        static_drw |= DRAW_MASK_TERR;
+    if (amptr->flags & AMAP_SHOW_SENS)
+        static_drw |= DRAW_MASK_SENS;
+    init_mapybase = mapybase;
+    init_yc = yc;
+
+    // what each tile gets drawn as, worked out once for all the passes
+    if ((max_xc > xbase) && (max_yc > yc) && ((max_xc - xbase) * (max_yc - yc) > amap_drws_size)) {
+        free(amap_drws);
+        amap_drws = (uchar *)malloc((max_xc - xbase) * (max_yc - yc));
+        amap_drws_size = (amap_drws != NULL) ? (max_xc - xbase) * (max_yc - yc) : 0;
+        if (amap_drws == NULL)
+            return;
+    }
+    for (d = amap_drws; yc < max_yc; yc++, mapybase += MAP_XSIZE)
+        for (curmp = mapybase, xc = xbase; xc < max_xc; xc++, curmp++) {
+            drw = static_drw;
+            if (me_bits_seen(curmp))
+                drw |= DRAW_MASK_SEEN;
+            if (fix_fast_pyth_dist((xc << 8) + 0x80 - sensor_x, (yc << 8) + 0x80 - sensor_y) < amptr->sensor_rad)
+                drw |= DRAW_MASK_RAD;
+            *d++ = drw;
+        }
+    yc = init_yc;
+
+    base = amap_get_base(amptr, amap_drws, xbase, yc, max_xc, max_yc, crnr_x, crnr_y, zeroscrx, zeroscry, sensor_x,
+                         sensor_y);
+    if (base != NULL) {
+        if (base->runs != NULL)
+            gr_scale_sprite(&base->sub, base->runs, fix_make(base->l, 0), fix_make(base->t, 0),
+                            fix_make(base->l + base->sub.w, 0), fix_make(base->t + base->sub.h, 0), NULL);
+        else if (base->sub.w > 0)
+            gr_bitmap(&base->sub, base->l, base->t);
+    }
+    else
+        amap_floors_and_walls(amptr, amap_drws, xbase, yc, max_xc, max_yc, crnr_x, crnr_y, sensor_x, sensor_y);
+    drw = static_drw;
 
     for (pass = 0; pass < NUM_OBJ_PASSES; pass++) {
         mapybase = init_mapybase;
         yc = init_yc;
-        for (ym = crnr_y; yc < max_yc; yc++, ym -= tsize, mapybase += MAP_XSIZE)
+        for (ym = crnr_y, d = amap_drws; yc < max_yc; yc++, ym -= tsize, mapybase += MAP_XSIZE)
             for (curmp = mapybase, xc = xbase, xm = crnr_x; xc < max_xc; xc++, xm += tsize, curmp++) {
-                drw = static_drw;
-                if (me_bits_seen(curmp))
-                    drw |= DRAW_MASK_SEEN;
-                if (fix_fast_pyth_dist((xc << 8) + 0x80 - sensor_x, (yc << 8) + 0x80 - sensor_y) < amptr->sensor_rad)
-                    drw |= DRAW_MASK_RAD;
-
+                drw = *d++;
                 obj_mess(amptr, curmp, drw, xm, ym, tsize, pass);
             }
     }
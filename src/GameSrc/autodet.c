@@ -0,0 +1,235 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/*
+ * autodet.c
+ *
+ * adaptive render detail
+ *
+ * Times the main 3d view every frame and walks a ladder of cheaper settings
+ *  when the smoothed time goes over the frame budget, and back up when there
+ *  is room again.  The rungs, from most to least expensive, pull in the texture
+ *  size drop radii, shrink the quality scale radius for objects and critters,
+ *  lower the detail level (which carries the perspective/linear mapper choice
+ *  and the lighting mode), and last of all, if allowed, go to half res.  What
+ *  the player picked is always the top rung, and is what gets saved in prefs.
+ *  Going to or from half res rebuilds the render canvases, which the rest of
+ *  this frame's views still draw into, so that waits for the main loop to
+ *  call autodet_between_frames.
+ */
+
+#include <SDL.h>
+
+#include "autodet.h"
+#include "frtypes.h"
+#include "frparams.h"
+#include "frprotox.h"
+#include "fullscrn.h"
+#include "mainloop.h"
+#include "render.h"
+#include "OpenGL.h"
+
+// how the budget is policed
+#define AD_AVG_SHF 3       // moving average weight, 1/8 for each new frame
+#define AD_DOWN_FRAMES 8   // frames over budget before we drop a rung
+#define AD_UP_FRAMES 90    // frames well under budget before we try one rung up
+#define AD_UP_PCT 70       // well under means this percent of the budget
+#define AD_UP_PCT_HALF 20  // coming back from half res roughly quadruples the pixels
+#define AD_HOLD_FRAMES 30  // after any change, let things settle this long
+
+typedef struct {
+    uchar drop_shrink; // taken off each texture drop radius
+    uchar qscale_drop; // taken off the object and critter quality scale radius
+    uchar det_drop;    // taken off the detail level
+    uchar half_res;    // go to DoubleSize
+} ad_rung;
+
+static ad_rung ad_ladder[] = {
+    {0, 0, 0, FALSE}, // what the player asked for
+    {1, 0, 0, FALSE}, {2, 1, 0, FALSE}, {2, 1, 1, FALSE}, {3, 2, 2, FALSE}, {3, 2, 3, FALSE}, {3, 2, 3, TRUE},
+};
+#define AD_RUNG_CNT (sizeof(ad_ladder) / sizeof(ad_ladder[0]))
+
+int autodet_budget = 0; // in milliseconds, 0 turns us off
+uchar autodet_half_res_ok = FALSE;
+
+static int ad_rung_cur = 0;
+static Uint64 ad_start;
+static int ad_avg = 0; // smoothed render time in microseconds
+static int ad_over = 0, ad_under = 0, ad_hold = 0;
+
+// what the player picked, and what we last wrote, so we notice when someone else changes things
+static int ad_user_detail, ad_set_detail = -1;
+static uchar ad_user_drop[TM_SIZE_CNT], ad_set_drop[TM_SIZE_CNT];
+static int ad_user_qobj, ad_user_qcrit;
+static bool ad_user_half;
+static uchar ad_half_pending = FALSE; // DoubleSize should become ad_half_want between frames
+static bool ad_half_want;
+
+extern bool DoubleSize;
+extern int _fr_global_detail;
+extern void change_svga_screen_mode(void);
+
+// Internal Prototypes
+static void ad_grab_user(void);
+static void ad_apply(int rung);
+static void ad_release(void);
+static void ad_set_half(bool half);
+
+static void ad_grab_user(void) {
+    int i;
+    ad_user_detail = _fr_global_detail;
+    for (i = 0; i < TM_SIZE_CNT; i++)
+        ad_user_drop[i] = _frp.view.drop_rad[i];
+    ad_user_qobj = fr_qscale_obj;
+    ad_user_qcrit = fr_qscale_crit;
+    ad_user_half = DoubleSize;
+}
+
+// ask for half res on or off, which happens in autodet_between_frames
+static void ad_set_half(bool half) {
+    ad_half_want = half;
+    ad_half_pending = (half != DoubleSize);
+}
+
+static void ad_apply(int rung) {
+    ad_rung *r = &ad_ladder[rung];
+    int i, det, q;
+
+    for (i = 0; i < TM_SIZE_CNT; i++) {
+        ad_set_drop[i] = (ad_user_drop[i] > r->drop_shrink) ? ad_user_drop[i] - r->drop_shrink : 0;
+        _frp.view.drop_rad[i] = ad_set_drop[i];
+    }
+    q = ad_user_qobj - r->qscale_drop;
+    fr_qscale_obj = (q > 0) ? q : 0;
+    q = ad_user_qcrit - r->qscale_drop;
+    fr_qscale_crit = (q > 0) ? q : 0;
+    det = ad_user_detail - r->det_drop;
+    ad_set_detail = _fr_global_detail = (det > 0) ? det : 0;
+    fr_use_global_detail(_current_fr_context); // the detail hotkey sets the context directly
+    ad_set_half(r->half_res || ad_user_half);
+
+    INFO("autodet: %d.%03dms avg vs %dms budget, rung %d -> %d (detail %d, drop -%d, qscale -%d%s)", ad_avg / 1000,
+         ad_avg % 1000, autodet_budget, ad_rung_cur, rung, _fr_global_detail, r->drop_shrink, r->qscale_drop,
+         (r->half_res || ad_user_half) ? ", half res" : "");
+    ad_rung_cur = rung;
+    ad_over = ad_under = 0;
+    ad_hold = AD_HOLD_FRAMES;
+}
+
+// someone else changed some of our settings, keep their changes, put back the rest, and start at the top
+static void ad_release(void) {
+    int i;
+    if (_fr_global_detail == ad_set_detail)
+        _fr_global_detail = ad_user_detail;
+    for (i = 0; i < TM_SIZE_CNT; i++)
+        if (_frp.view.drop_rad[i] == ad_set_drop[i])
+            _frp.view.drop_rad[i] = ad_user_drop[i];
+    fr_qscale_obj = ad_user_qobj;
+    fr_qscale_crit = ad_user_qcrit;
+    if ((DoubleSize == ad_ladder[ad_rung_cur].half_res) && (DoubleSize != ad_user_half))
+        ad_set_half(ad_user_half);
+    else
+        ad_half_pending = FALSE;
+    ad_rung_cur = 0;
+    ad_grab_user();
+    ad_over = ad_under = 0;
+    ad_hold = AD_HOLD_FRAMES;
+}
+
+void autodet_frame_start(void) { ad_start = SDL_GetPerformanceCounter(); }
+
+void autodet_frame_end(void) {
+    int us, i, up_pct;
+    uchar moved = FALSE;
+
+    us = (int)(((SDL_GetPerformanceCounter() - ad_start) * 1000000) / SDL_GetPerformanceFrequency());
+    if ((autodet_budget <= 0) || use_opengl()) {
+        if (ad_rung_cur != 0)
+            autodet_reset();
+        return;
+    }
+    if (ad_avg == 0)
+        ad_avg = us;
+    else
+        ad_avg += (us - ad_avg) >> AD_AVG_SHF;
+
+    // if the player, or a mode change, moved something under us, that is the new top rung
+    // (not while a res change is waiting, DoubleSize is still the old one till it happens)
+    if (ad_half_pending)
+        moved = FALSE;
+    else if (ad_rung_cur == 0)
+        ad_grab_user();
+    else {
+        if (_fr_global_detail != ad_set_detail)
+            moved = TRUE;
+        for (i = 0; i < TM_SIZE_CNT; i++)
+            if (_frp.view.drop_rad[i] != ad_set_drop[i])
+                moved = TRUE;
+        if (DoubleSize != (ad_ladder[ad_rung_cur].half_res || ad_user_half))
+            moved = TRUE;
+        if (moved) {
+            INFO("autodet: settings changed from outside, starting over");
+            ad_release();
+        }
+    }
+
+    if (ad_hold > 0) {
+        ad_hold--;
+        return;
+    }
+    if (ad_avg > autodet_budget * 1000) {
+        ad_under = 0;
+        if ((++ad_over >= AD_DOWN_FRAMES) && (ad_rung_cur + 1 < AD_RUNG_CNT)) {
+            if (ad_ladder[ad_rung_cur + 1].half_res && (!autodet_half_res_ok || ad_user_half))
+                return; // nowhere cheaper to go
+            ad_apply(ad_rung_cur + 1);
+        }
+    } else {
+        ad_over = 0;
+        up_pct = ad_ladder[ad_rung_cur].half_res ? AD_UP_PCT_HALF : AD_UP_PCT;
+        if (ad_avg < (autodet_budget * 10 * up_pct)) {
+            if ((++ad_under >= AD_UP_FRAMES) && (ad_rung_cur > 0))
+                ad_apply(ad_rung_cur - 1);
+        } else
+            ad_under = 0;
+    }
+}
+
+// put everything back the way the player had it
+void autodet_reset(void) {
+    if (ad_rung_cur != 0)
+        ad_apply(0);
+    ad_avg = 0;
+}
+
+// the main loop, once the frame is up, makes any res change we asked for, only
+//  in the game views, anywhere else is left alone and noticed as an outside change
+void autodet_between_frames(void) {
+    if (!ad_half_pending)
+        return;
+    ad_half_pending = FALSE;
+    if (((_current_loop != GAME_LOOP) && (_current_loop != FULLSCREEN_LOOP)) || (DoubleSize == ad_half_want))
+        return;
+    DoubleSize = ad_half_want;
+    change_svga_screen_mode();
+}
+
+int autodet_user_detail(void) { return (ad_rung_cur == 0) ? _fr_global_detail : ad_user_detail; }
+
+bool autodet_user_half_res(void) { return ((ad_rung_cur == 0) && !ad_half_pending) ? DoubleSize : ad_user_half; }
@@ -271,6 +271,27 @@ extern uchar handart_flash;
 
 #define DEFAULT_ANIMATION_SPEED 32
 
+// Looping display screens with nobody waiting on a callback only matter when
+//  someone looks at them, so increment_anim just banks their time, and
+//  anim_catch_up spends it when the screen is drawn.  The id is kept so we
+//  notice when the list is shuffled or reloaded under us.
+typedef struct {
+    ObjID id;
+    ulong units;
+} AnimLazy;
+static AnimLazy anim_lazy[MAX_ANIMLIST_SIZE];
+extern uchar obj_is_display(int triple);
+
+#define anim_is_lazy(i)                                                                                    \
+    ((animlist[i].callback == 0) && ((animlist[i].flags & (ANIMFLAG_REPEAT | ANIMFLAG_CYCLE)) == ANIMFLAG_REPEAT) && \
+     (objs[animlist[i].id].obclass == CLASS_BIGSTUFF) && obj_is_display(ID2TRIP(animlist[i].id)))
+
+// and the texture groups, all the time gone by, how much of it each group has
+// been stepped through, and which groups moved since the prefetcher looked
+static ulong animtext_clock = 0;
+static ulong animtext_seen[NUM_ANIM_TEXTURE_GROUPS];
+uchar animtext_changed = 0;
+
 #ifdef USE_ANIMCRIT_DEFS
 #define STANDARD_CRITTER_SPEED fix_make(0, 0x4000)
 #define MIN_CRITTER_ANIM_SPEED 25
@@ -439,6 +460,14 @@ errtype increment_anim(ulong num_units) {
     LG_memset(cb_list, 0, MAX_ANIMLIST_SIZE);
     for (i = 0; i < anim_counter; i++) {
         id = animlist[i].id;
+        if (anim_is_lazy(i)) {
+            if (anim_lazy[i].id != id) {
+                anim_lazy[i].id = id;
+                anim_lazy[i].units = 0;
+            }
+            anim_lazy[i].units += num_units;
+            continue;
+        }
         num_frames = anim_frames(id);
         new_units = num_units + objs[id].info.time_remainder;
         interval = new_units / animlist[i].speed;
@@ -622,39 +651,83 @@ errtype increment_anim(ulong num_units) {
         osid = objCritters[osid].next;
     }
 
-    // Animating Textures
-    // Start at 1, since 0 is the normal texture group
-    for (i = 1; i < NUM_ANIM_TEXTURE_GROUPS; i++) {
-        if (animtextures[i].num_frames > 0) {
-            new_units = num_units + animtextures[i].time_remainder;
-            interval = new_units / animtextures[i].anim_speed;
-            animtextures[i].time_remainder = new_units % animtextures[i].anim_speed;
-            while (interval > 0) {
-                if (animtextures[i].flags & ANIMTEXTURE_REVERSED) {
-                    // Currently, REVERSED implies CYCLE.  Maybe this should change
-                    // in the future.
-                    animtextures[i].current_frame--;
-                    if (animtextures[i].current_frame < 0) {
-                        animtextures[i].flags &= ~(ANIMTEXTURE_REVERSED);
-                        animtextures[i].current_frame = 0;
-                    }
+    // Animating Textures, stepped when a tile using them next draws, see animtext_catch_up
+    animtext_clock += num_units;
+    destroy_destroyed_objects();
+    return (OK);
+}
+
+// spend the time a lazy screen has banked, called before its frame is used to draw
+void anim_catch_up(ObjID id) {
+    int i, num_frames, interval;
+    ulong new_units;
+
+    for (i = 0; i < anim_counter; i++)
+        if (animlist[i].id == id)
+            break;
+    if ((i == anim_counter) || (anim_lazy[i].id != id) || (anim_lazy[i].units == 0))
+        return;
+    num_frames = anim_frames(id);
+    new_units = anim_lazy[i].units + objs[id].info.time_remainder;
+    anim_lazy[i].units = 0;
+    interval = (new_units / animlist[i].speed) % num_frames;
+    objs[id].info.time_remainder = new_units % animlist[i].speed;
+    if (animlist[i].flags & ANIMFLAG_REVERSE)
+        objs[id].info.current_frame = ((objs[id].info.current_frame % num_frames) + num_frames - interval) % num_frames;
+    else
+        objs[id].info.current_frame = (objs[id].info.current_frame + interval) % num_frames;
+}
+
+// step an animating texture group by whatever time has gone by since it was
+// last drawn, called before its frame is used to draw a tile
+void animtext_catch_up(int g) {
+    int interval;
+    ulong new_units;
+    char old_frame;
+
+    // 0 is the normal texture group
+    if ((g <= 0) || (animtextures[g].num_frames <= 0) || (animtext_seen[g] == animtext_clock))
+        return;
+    old_frame = animtextures[g].current_frame;
+    new_units = (animtext_clock - animtext_seen[g]) + animtextures[g].time_remainder;
+    animtext_seen[g] = animtext_clock;
+    interval = new_units / animtextures[g].anim_speed;
+    animtextures[g].time_remainder = new_units % animtextures[g].anim_speed;
+    // a cycling group comes back around after twice its frames, one going each way
+    interval %= (animtextures[g].flags & ANIMTEXTURE_CYCLE) ? 2 * animtextures[g].num_frames
+                                                             : animtextures[g].num_frames;
+    while (interval > 0) {
+        if (animtextures[g].flags & ANIMTEXTURE_REVERSED) {
+            // Currently, REVERSED implies CYCLE.  Maybe this should change
+            // in the future.
+            animtextures[g].current_frame--;
+            if (animtextures[g].current_frame < 0) {
+                animtextures[g].flags &= ~(ANIMTEXTURE_REVERSED);
+                animtextures[g].current_frame = 0;
+            }
+        } else {
+            animtextures[g].current_frame++;
+            if (animtextures[g].current_frame >= animtextures[g].num_frames) {
+                if (animtextures[g].flags & ANIMTEXTURE_CYCLE) {
+                    animtextures[g].flags |= ANIMTEXTURE_REVERSED;
+                    animtextures[g].current_frame = animtextures[g].num_frames - 1;
                 } else {
-                    animtextures[i].current_frame++;
-                    if (animtextures[i].current_frame >= animtextures[i].num_frames) {
-                        if (animtextures[i].flags & ANIMTEXTURE_CYCLE) {
-                            animtextures[i].flags |= ANIMTEXTURE_REVERSED;
-                            animtextures[i].current_frame = animtextures[i].num_frames - 1;
-                        } else {
-                            animtextures[i].current_frame = 0;
-                        }
-                    }
+                    animtextures[g].current_frame = 0;
                 }
-                interval--;
             }
         }
+        interval--;
     }
-    destroy_destroyed_objects();
-    return (OK);
+    if (animtextures[g].current_frame != old_frame)
+        animtext_changed |= (1 << g);
+}
+
+// bring every group up to date, for when their frames get saved
+void animtext_catch_up_all(void) {
+    int i;
+
+    for (i = 1; i < NUM_ANIM_TEXTURE_GROUPS; i++)
+        animtext_catch_up(i);
 }
 
 void advance_animations(void) {
@@ -734,6 +807,9 @@ errtype add_obj_to_animlist(ObjID id, uchar repeat, uchar reverse, uchar cycle,
     if (!replace_me)
         anim_counter++;
 
+    // a new entry, or the old one starting over, has nothing banked
+    anim_lazy[use_counter].id = id;
+    anim_lazy[use_counter].units = 0;
     objs[id].info.time_remainder = 0;
     return (OK);
 }
@@ -751,6 +827,7 @@ errtype remove_obj_from_animlist(ObjID id) {
             }
             anim_counter--;
             animlist[i] = animlist[anim_counter];
+            anim_lazy[i] = anim_lazy[anim_counter];
             if (cb != NULL)
                 cb(id, ud);
             return (OK);
@@ -762,9 +839,20 @@ errtype remove_obj_from_animlist(ObjID id) {
 errtype animlist_clear() {
     LG_memset(animlist, 0, sizeof(AnimListing) * MAX_ANIMLIST_SIZE);
     anim_counter = 0;
+    anim_lazy_reset();
     return (OK);
 }
 
+// drop whatever time the lazy screens and texture groups had banked, for when
+// the list is loaded over
+void anim_lazy_reset(void) {
+    int i;
+
+    LG_memset(anim_lazy, 0, sizeof(anim_lazy));
+    for (i = 0; i < NUM_ANIM_TEXTURE_GROUPS; i++)
+        animtext_seen[i] = animtext_clock;
+}
+
 void init_animlist(void) {
     extern void diego_teleport_callback(ObjID id, void *user_data);
     extern void destroy_screen_callback_func(ObjID id, void *user_data);
@@ -0,0 +1,154 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/*
+ * framelim.c
+ *
+ * frame rate cap for the main loop
+ *
+ * The main loop runs flat out, and presenting with vsync is its only brake,
+ *  which does nothing on a headless or virtual display.  This holds each
+ *  frame to a fixed period measured from the last deadline, not from when
+ *  the frame finished, so the rate doesn't drift.  Waiting is mostly sleep,
+ *  and the last little bit is a spin on the performance counter, as sleeps
+ *  only come in whole milliseconds and often run over; how much to spin is
+ *  learned from how far recent sleeps have run over.  When the window isn't
+ *  focused, is minimized, or the game is paused, a lower cap can apply, and
+ *  then it just sleeps, as nobody is watching that closely.
+ */
+
+#include <math.h>
+#include <SDL.h>
+
+#include "framelim.h"
+#include "mainloop.h"
+
+#define FL_MARGIN_MIN 250    // microseconds of spin, at least
+#define FL_MARGIN_MAX 4000   // and at most, past this the sleeps are hopeless anyway
+#define FL_MARGIN_DECAY 4    // margin shrinks by 1/16 a frame toward the latest oversleep
+#define FL_LATE_US 1000      // a frame this far past its deadline counts as late
+#define FL_REPORT_SECS 10
+
+int framelim_fps = 0;
+int framelim_idle_fps = 15;
+uchar framelim_stats = FALSE;
+void (*framelim_report_func)(void) = NULL;
+
+extern SDL_Window *window;
+extern uchar game_paused;
+
+static Uint64 fl_next;      // when this frame should end
+static Uint64 fl_last;      // when the last one did
+static int fl_margin = 1000; // spin this long before the deadline, in microseconds
+
+// frame time statistics since the last report
+static Uint64 fl_report;
+static int fl_frames, fl_late, fl_min, fl_max;
+static double fl_sum, fl_sumsq;
+
+// Internal Prototypes
+static int fl_us(Uint64 a, Uint64 b);
+static void fl_sleep_until(Uint64 when, uchar spin);
+static void fl_count(Uint64 now);
+
+static int fl_us(Uint64 a, Uint64 b) { return (int)(((Sint64)(b - a) * 1000000) / (Sint64)SDL_GetPerformanceFrequency()); }
+
+static void fl_sleep_until(Uint64 when, uchar spin) {
+    Uint64 now = SDL_GetPerformanceCounter(), t;
+    int left = fl_us(now, when), ms, over;
+
+    ms = (left - (spin ? fl_margin : 0)) / 1000;
+    if (ms > 0) {
+        t = now;
+        SDL_Delay(ms);
+        now = SDL_GetPerformanceCounter();
+        over = fl_us(t, now) - ms * 1000;
+        if (over > fl_margin)
+            fl_margin = over;
+        else
+            fl_margin -= (fl_margin - over) >> FL_MARGIN_DECAY;
+        if (fl_margin < FL_MARGIN_MIN)
+            fl_margin = FL_MARGIN_MIN;
+        if (fl_margin > FL_MARGIN_MAX)
+            fl_margin = FL_MARGIN_MAX;
+    }
+    if (spin)
+        while (SDL_GetPerformanceCounter() < when)
+            ;
+}
+
+static void fl_count(Uint64 now) {
+    int us, avg, sd;
+
+    if (fl_last != 0) {
+        us = fl_us(fl_last, now);
+        if ((fl_frames == 0) || (us < fl_min))
+            fl_min = us;
+        if (us > fl_max)
+            fl_max = us;
+        fl_sum += us;
+        fl_sumsq += (double)us * us;
+        fl_frames++;
+    }
+    fl_last = now;
+
+    if (fl_report == 0)
+        fl_report = now;
+    if ((fl_frames > 1) && (fl_us(fl_report, now) >= FL_REPORT_SECS * 1000000)) {
+        avg = (int)(fl_sum / fl_frames);
+        sd = (int)sqrt(fl_sumsq / fl_frames - (double)avg * avg);
+        INFO("framelim: %d frames, %d.%03dms avg, %d.%03dms jitter (sd), %d.%03d-%d.%03dms, %d late, spin %dus",
+             fl_frames, avg / 1000, avg % 1000, sd / 1000, sd % 1000, fl_min / 1000, fl_min % 1000, fl_max / 1000,
+             fl_max % 1000, fl_late, fl_margin);
+        if (framelim_report_func != NULL)
+            framelim_report_func();
+        fl_frames = fl_late = fl_max = 0;
+        fl_sum = fl_sumsq = 0;
+        fl_report = now;
+    }
+}
+
+void framelim_frame_end(void) {
+    Uint64 now = SDL_GetPerformanceCounter(), period;
+    uchar idle = game_paused || (window == NULL) ||
+                 ((SDL_GetWindowFlags(window) & (SDL_WINDOW_INPUT_FOCUS | SDL_WINDOW_MINIMIZED)) != SDL_WINDOW_INPUT_FOCUS);
+    int fps = framelim_fps;
+
+    if (idle && (framelim_idle_fps > 0) && ((fps <= 0) || (framelim_idle_fps < fps)))
+        fps = framelim_idle_fps;
+    else
+        idle = FALSE;
+
+    if (fps > 0) {
+        period = SDL_GetPerformanceFrequency() / fps;
+        if ((fl_next != 0) && (now > fl_next) && (fl_us(fl_next, now) > FL_LATE_US))
+            fl_late++;
+        // off by more than a frame, from a load or a cap change, start counting from now
+        if ((fl_next == 0) || (now > fl_next + period) || (fl_next > now + period))
+            fl_next = now + period;
+        else {
+            if (now < fl_next)
+                fl_sleep_until(fl_next, !idle);
+            fl_next += period;
+        }
+    } else
+        fl_next = 0;
+
+    if (framelim_stats)
+        fl_count(SDL_GetPerformanceCounter());
+}
@@ -62,6 +62,7 @@ void fr_compile_rect(fmp *fmptr, int llx, int lly, int ulx, int uly, uchar seen_
         ulx++;
     else
         ulx = fm_x_sz(fm) - 1;
+    fr_pvs_map_changed(fm, llx, lly, ulx, uly);
     y = lly;
     x = llx;
     for (; y <= uly; y++) {
@@ -106,6 +106,8 @@ int fr_rend(frc *view) {
         // printf(" fr_clip_tile\n");
         fr_clip_tile(); /* clipping and obj sort pass */
 
+        fr_pvs_prune(); /* drop tiles which can never be seen from here */
+
         // MLA - does nothing!
         // synchronous_update();            // One more time
         //    	ClearCache(_fr->draw_canvas.bm.bits, (_fr->draw_canvas.bm.row >> 5) * _fr->ywid);
@@ -166,6 +166,7 @@ int fr_pipe_resize(int x, int y, int z, void *mptr) {
     _fr_init_slopes(fr_map_z = z);
     fr_pts_resize(x, y);
     fr_clip_resize(x, y);
+    fr_pvs_resize(x, y);
     tf_diag_walls[0][1] = tf_diag_walls[1][1] = fix_make(HGT_STEPS, 0) >> z;
     fr_map_base = (MapElem *)mptr;
     for (i = 0; i < 4; i++)
@@ -70,14 +70,66 @@ static int _fr_pt_wid = 0;
 #endif
 g3s_phandle *_fr_ptbase, *_fr_ptnext; /* global place to get points from */
 
+// per frame cache of finished terrain points, keyed by grid corner, height and half point mod
+// a corner is shared by up to four tiles and all their walls, this way it gets transformed
+// and projected once.  direct mapped, a collision just throws the old point out
+#define PT_CACHE_SIZE 1024
+typedef struct {
+    uint frame;
+    short cx, cy;
+    fix dy, arg;
+    int mod;
+    g3s_point pt;
+} pt_cache_ent;
+static pt_cache_ent pt_cache[PT_CACHE_SIZE];
+static uint pt_cache_frame = 0;
+int fr_pt_cache_hits = 0, fr_pt_cache_misses = 0; /* since last fr_pts_cache_stats */
+
 // i drank so much tea, i wrote my letters in kanji
 // round and round the block i walked, pretending you were with me
 int fr_pts_frame_start(void) {
     LG_memset(*(pt_rowv + 0), 0xffff, _fr_pt_wid * sizeof(ushort));
     LG_memset(*(pt_rowv + 1), 0xffff, _fr_pt_wid * sizeof(ushort));
+    if (++pt_cache_frame == 0) { // on wrap, make sure nothing old looks current
+        LG_memset(pt_cache, 0, sizeof(pt_cache));
+        pt_cache_frame = 1;
+    }
     _fr_ret;
 }
 
+// find the slot for a point, *hit says if it is already good for this frame
+// on a miss the slot is claimed, and the caller copies the finished point into it
+g3s_phandle fr_pts_cache_slot(int cx, int cy, fix dy, int mod, fix arg, uchar *hit) {
+    pt_cache_ent *ent;
+
+    ent = &pt_cache[((cx * 73) + (cy * 151) + (dy >> 10) + (mod * 7) + (arg >> 8)) & (PT_CACHE_SIZE - 1)];
+    if ((ent->frame == pt_cache_frame) && (ent->cx == cx) && (ent->cy == cy) && (ent->dy == dy) &&
+        (ent->mod == mod) && (ent->arg == arg)) {
+        fr_pt_cache_hits++;
+        *hit = TRUE;
+    } else {
+        fr_pt_cache_misses++;
+        ent->frame = pt_cache_frame;
+        ent->cx = cx;
+        ent->cy = cy;
+        ent->dy = dy;
+        ent->mod = mod;
+        ent->arg = arg;
+        *hit = FALSE;
+    }
+    return &ent->pt;
+}
+
+// log and reset the hit rate, percent of lookups that were hits
+int fr_pts_cache_stats(void) {
+    int tot = fr_pt_cache_hits + fr_pt_cache_misses, pct = 0;
+    if (tot > 0)
+        pct = (fr_pt_cache_hits * 100) / tot;
+    DEBUG("%s: %d hits %d misses (%d%%)", __FUNCTION__, fr_pt_cache_hits, fr_pt_cache_misses, pct);
+    fr_pt_cache_hits = fr_pt_cache_misses = 0;
+    return pct;
+}
+
 int fr_pts_freemem(void) {
 #ifdef MAP_RESIZING
     int i;
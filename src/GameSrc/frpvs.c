@@ -0,0 +1,361 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/*
+ * FrPvs.c
+ *
+ * Citadel Renderer
+ *  potentially visible set per map tile
+ *
+ * For each tile the eye can stand in we keep a bitset of every tile that
+ *  could ever be seen from anywhere inside it.  They are all built when
+ *  fr_compile_rect first hands us a map, so nothing is cast while playing.
+ *  A tile's set is everything seen from its four corners, plus one tile of
+ *  slack all round for sight lines that only exist from inside it.  Seeing
+ *  from a corner is done exactly: walls and the grid are all tile edges, so
+ *  what a ray passes through only changes at grid corners, and a ray is
+ *  cast through every corner in the map.  Ties go to seeing more: a ray
+ *  through a corner sees both tiles it grazes and carries on between them,
+ *  and a ray along a grid line goes on until both sides are solid.
+ *  Anything that is not fully solid (diagonals, slopes, door tiles, closed
+ *  elevators) lets rays through, so door and height state never needs to be
+ *  tracked here.  When a tile stops being solid the sets which see it are
+ *  built again.  When one becomes solid the sets can only have got too big,
+ *  which is still safe, so they are left alone.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#define __FRPVS_SRC
+#include "map.h"
+#include "mapflags.h"
+#include "tilename.h"
+#include "frsubclp.h"
+
+#include "frintern.h"
+#include "frspans.h"
+#include "frparams.h"
+#include "frflags.h"
+
+#define PVS_ROW_WORDS(sz) (((sz) + 31) >> 5)
+#define pvs_bit_set(row, idx) ((row)[(idx) >> 5] |= (1u << ((idx)&31)))
+#define pvs_bit_clr(row, idx) ((row)[(idx) >> 5] &= ~(1u << ((idx)&31)))
+#define pvs_bit_tst(row, idx) ((row)[(idx) >> 5] & (1u << ((idx)&31)))
+
+uchar fr_pvs_on = TRUE; // use the pvs to prune the tile pass
+
+static FullMap *pvs_map = NULL; // the map the rows were built from
+static uint *pvs_rows = NULL;   // one bitset per source tile, pvs_words long
+static uint *pvs_solid = NULL;  // which tiles were solid when the rows were built
+static int pvs_x = 0, pvs_y = 0, pvs_words = 0;
+static uchar pvs_ready = FALSE; // every row of pvs_map is built
+
+#define pvs_row(idx) (pvs_rows + (idx)*pvs_words)
+#define pvs_solid_at(x, y) (me_tiletype(FULLMAP_GET_XY(pvs_map, x, y)) == TILE_SOLID)
+
+// Prototypes
+static void pvs_cast_line(uint *vis, int vx, int vy, int dx, int dy);
+static void pvs_cast_ray(uint *vis, int vx, int vy, int dx, int dy);
+static void pvs_cast_corner(uint *vis, uchar *prime, int vx, int vy);
+static int pvs_build(uint *need);
+
+void fr_pvs_flush(void) {
+    if (pvs_ready)
+        DEBUG("%s: dropped pvs rows", __FUNCTION__);
+    pvs_ready = FALSE;
+}
+
+int fr_pvs_resize(int x, int y) {
+    fr_pvs_flush();
+    if (pvs_rows != NULL)
+        free(pvs_rows);
+    if (pvs_solid != NULL)
+        free(pvs_solid);
+    pvs_x = x;
+    pvs_y = y;
+    pvs_words = PVS_ROW_WORDS(x * y);
+    pvs_rows = (uint *)malloc(x * y * pvs_words * sizeof(uint));
+    pvs_solid = (uint *)calloc(pvs_words, sizeof(uint));
+    _fr_dbg(if ((pvs_rows == NULL) || (pvs_solid == NULL)) _fr_ret_val(FR_NOMEM));
+    _fr_ret;
+}
+
+// called from fr_compile_rect with the map it is compiling, only solidity matters
+//  to us, so height changes from doors and elevators dont cost a rebuild
+void fr_pvs_map_changed(fmp *fmptr, int llx, int lly, int ulx, int uly) {
+    FullMap *fm = (FullMap *)fmptr;
+    uint *opened, *need;
+    int x, y, idx, i;
+    uchar solid, any = FALSE;
+
+    if ((pvs_rows == NULL) || (pvs_solid == NULL) || (fm_x_sz(fm) != pvs_x) || (fm_y_sz(fm) != pvs_y))
+        return;
+    if ((fm != pvs_map) || !pvs_ready) {
+        // a new map, so take all of it as it is now
+        pvs_map = fm;
+        for (y = 0; y < pvs_y; y++)
+            for (x = 0; x < pvs_x; x++)
+                if (pvs_solid_at(x, y))
+                    pvs_bit_set(pvs_solid, x + y * pvs_x);
+                else
+                    pvs_bit_clr(pvs_solid, x + y * pvs_x);
+        pvs_ready = (pvs_build(NULL) == FR_OK);
+        return;
+    }
+    if ((opened = (uint *)calloc(2 * pvs_words, sizeof(uint))) == NULL) {
+        fr_pvs_flush();
+        return;
+    }
+    for (y = lly; y <= uly; y++)
+        for (x = llx; x <= ulx; x++) {
+            idx = x + y * pvs_x;
+            solid = pvs_solid_at(x, y);
+            if (solid == (pvs_bit_tst(pvs_solid, idx) != 0))
+                continue;
+            if (solid)
+                pvs_bit_set(pvs_solid, idx);
+            else {
+                pvs_bit_clr(pvs_solid, idx);
+                pvs_bit_set(opened, idx);
+                any = TRUE;
+            }
+        }
+    if (any) {
+        // the opened tiles need rows now, and any row that sees one of them may
+        //  see through it now, those are the only rows that can have grown
+        need = opened + pvs_words;
+        memcpy(need, opened, pvs_words * sizeof(uint));
+        for (idx = 0; idx < pvs_x * pvs_y; idx++)
+            if (!pvs_bit_tst(pvs_solid, idx))
+                for (i = 0; i < pvs_words; i++)
+                    if (pvs_row(idx)[i] & opened[i]) {
+                        pvs_bit_set(need, idx);
+                        break;
+                    }
+        if (pvs_build(need) != FR_OK)
+            fr_pvs_flush();
+    }
+    free(opened);
+}
+
+// a ray from a corner straight along a grid line, it sees the tiles on both
+//  sides and only stops when both of those are solid
+static void pvs_cast_line(uint *vis, int vx, int vy, int dx, int dy) {
+    int tx[2], ty[2], i;
+    uchar open;
+
+    if (dx != 0) {
+        tx[0] = tx[1] = (dx > 0) ? vx : vx - 1;
+        ty[0] = vy - 1;
+        ty[1] = vy;
+    } else {
+        ty[0] = ty[1] = (dy > 0) ? vy : vy - 1;
+        tx[0] = vx - 1;
+        tx[1] = vx;
+    }
+    do {
+        open = FALSE;
+        for (i = 0; i < 2; i++) {
+            if ((tx[i] < 0) || (tx[i] >= pvs_x) || (ty[i] < 0) || (ty[i] >= pvs_y))
+                continue;
+            pvs_bit_set(vis, tx[i] + ty[i] * pvs_x);
+            if (!pvs_solid_at(tx[i], ty[i]))
+                open = TRUE;
+            tx[i] += dx;
+            ty[i] += dy;
+        }
+    } while (open);
+}
+
+// a ray from corner vx,vy through corner vx+dx,vy+dy and on, marking every tile
+//  it touches, up to and including the first solid one it goes into
+static void pvs_cast_ray(uint *vis, int vx, int vy, int dx, int dy) {
+    int stepx = (dx > 0) ? 1 : -1, stepy = (dy > 0) ? 1 : -1;
+    int mx = (dx > 0) ? vx : vx - 1, my = (dy > 0) ? vy : vy - 1;
+    int adx = abs(dx), ady = abs(dy);
+    int tmx = ady, tmy = adx; // where the next x and y gridlines get crossed, scaled by adx*ady
+
+    for (;;) {
+        if ((mx < 0) || (mx >= pvs_x) || (my < 0) || (my >= pvs_y))
+            return;
+        pvs_bit_set(vis, mx + my * pvs_x);
+        if (pvs_solid_at(mx, my))
+            return; // we see its walls, but nothing past it
+        if (tmx < tmy) {
+            mx += stepx;
+            tmx += ady;
+        } else if (tmy < tmx) {
+            my += stepy;
+            tmy += adx;
+        } else { // straight through a corner, the two tiles beside it are seen too
+            if ((mx + stepx >= 0) && (mx + stepx < pvs_x))
+                pvs_bit_set(vis, mx + stepx + my * pvs_x);
+            if ((my + stepy >= 0) && (my + stepy < pvs_y))
+                pvs_bit_set(vis, mx + (my + stepy) * pvs_x);
+            mx += stepx;
+            my += stepy;
+            tmx += ady;
+            tmy += adx;
+        }
+    }
+}
+
+// everything which can be seen from the grid corner vx,vy
+// prime has a 1 for each dx,dy with no common factor, there is one ray for each of
+//  those, any other corner is on the way to one of them
+static void pvs_cast_corner(uint *vis, uchar *prime, int vx, int vy) {
+    int dx, dy, x, y;
+
+    memset(vis, 0, pvs_words * sizeof(uint));
+    for (y = vy - 1; y <= vy; y++)
+        for (x = vx - 1; x <= vx; x++)
+            if ((x >= 0) && (x < pvs_x) && (y >= 0) && (y < pvs_y))
+                pvs_bit_set(vis, x + y * pvs_x);
+    pvs_cast_line(vis, vx, vy, 1, 0);
+    pvs_cast_line(vis, vx, vy, -1, 0);
+    pvs_cast_line(vis, vx, vy, 0, 1);
+    pvs_cast_line(vis, vx, vy, 0, -1);
+    for (dy = -vy; dy <= pvs_y - vy; dy++)
+        for (dx = -vx; dx <= pvs_x - vx; dx++)
+            if (prime[abs(dx) + abs(dy) * (pvs_x + 1)])
+                pvs_cast_ray(vis, vx, vy, dx, dy);
+}
+
+// build the rows of every open tile set in need, or every open tile if need is NULL
+// a row of corners is shared by the rows of tiles above and below it, so two are kept
+static int pvs_build(uint *need) {
+    uint *corners, *top, *bot, *seen, *row, *swap, *c[4];
+    uchar *done, *prime;
+    int sx, sy, idx, i, j, x, y, built = 0;
+
+    corners = (uint *)malloc((2 * (pvs_x + 1) + 1) * pvs_words * sizeof(uint));
+    done = (uchar *)malloc(2 * (pvs_x + 1) + (pvs_x + 1) * (pvs_y + 1));
+    if ((corners == NULL) || (done == NULL)) {
+        free(corners);
+        free(done);
+        _fr_ret_val(FR_NOMEM);
+    }
+    // sieve out every dx,dy with a common factor, and the axes, which cast_line does
+    prime = done + 2 * (pvs_x + 1);
+    memset(prime, 1, (pvs_x + 1) * (pvs_y + 1));
+    for (y = 0; y <= pvs_y; y++)
+        prime[y * (pvs_x + 1)] = 0;
+    memset(prime, 0, pvs_x + 1);
+    for (i = 2; (i <= pvs_x) && (i <= pvs_y); i++)
+        for (y = i; y <= pvs_y; y += i)
+            for (x = i; x <= pvs_x; x += i)
+                prime[x + y * (pvs_x + 1)] = 0;
+    top = corners;
+    bot = corners + (pvs_x + 1) * pvs_words;
+    seen = bot + (pvs_x + 1) * pvs_words;
+    memset(done, 0, 2 * (pvs_x + 1));
+    for (sy = 0; sy < pvs_y; sy++) {
+        for (sx = 0; sx < pvs_x; sx++) {
+            idx = sx + sy * pvs_x;
+            if (pvs_bit_tst(pvs_solid, idx) || ((need != NULL) && !pvs_bit_tst(need, idx)))
+                continue;
+            // the four corners, top is corner row sy, bot is sy+1
+            for (i = 0; i < 4; i++) {
+                x = sx + (i & 1);
+                j = (i >> 1) * (pvs_x + 1) + x;
+                c[i] = ((i >> 1) ? bot : top) + x * pvs_words;
+                if (!done[j]) {
+                    pvs_cast_corner(c[i], prime, x, sy + (i >> 1));
+                    done[j] = TRUE;
+                }
+            }
+            // what they see, and the tiles around that
+            for (i = 0; i < pvs_words; i++)
+                seen[i] = c[0][i] | c[1][i] | c[2][i] | c[3][i];
+            row = pvs_row(idx);
+            memset(row, 0, pvs_words * sizeof(uint));
+            for (j = 0; j < pvs_x * pvs_y; j++) {
+                if (seen[j >> 5] == 0) {
+                    j |= 31;
+                    continue;
+                }
+                if (!pvs_bit_tst(seen, j))
+                    continue;
+                x = j % pvs_x;
+                y = j / pvs_x;
+                for (i = 0; i < 9; i++)
+                    if ((x + i % 3 - 1 >= 0) && (x + i % 3 - 1 < pvs_x) && (y + i / 3 - 1 >= 0) &&
+                        (y + i / 3 - 1 < pvs_y))
+                        pvs_bit_set(row, j + (i % 3 - 1) + (i / 3 - 1) * pvs_x);
+            }
+            built++;
+        }
+        // corner row sy+1 is the top of the next tile row
+        swap = top;
+        top = bot;
+        bot = swap;
+        memcpy(done, done + pvs_x + 1, pvs_x + 1);
+        memset(done + pvs_x + 1, 0, pvs_x + 1);
+    }
+    free(corners);
+    free(done);
+    DEBUG("%s: built %d pvs rows", __FUNCTION__, built);
+    _fr_ret;
+}
+
+// the row for a source tile, NULL if we cant use the pvs there
+static uint *pvs_get_row(int sx, int sy) {
+    if (!pvs_ready || (sx < 0) || (sx >= pvs_x) || (sy < 0) || (sy >= pvs_y))
+        return NULL;
+    if (pvs_bit_tst(pvs_solid, sx + sy * pvs_x))
+        return NULL; // eye in a wall, all bets are off
+    return pvs_row(sx + sy * pvs_x);
+}
+
+// run after the tile clipper, kill any coned tile the pvs rules out, and pull in the pipe
+// distance to the farthest tile that survived, so the diamond walk stops early too.  the
+// clipper still walks every coned tile, as its vectors read the subclip bits this writes,
+// so what this saves is the drawing pass
+int fr_pvs_prune(void) {
+    uint *row;
+    int y, x, dist, far_dist = 0;
+    MapElem *mptr;
+    extern MapElem *fr_map_base;
+    extern ushort frpipe_dist;
+
+    if (!fr_pvs_on || !pvs_ready || (fm_map(pvs_map) != fr_map_base) || pvs_map->cyber ||
+        (_fr_curflags & FR_SHOWALL_MASK))
+        _fr_ret;
+    if ((row = pvs_get_row(_fr_x_cen, _fr_y_cen)) == NULL)
+        _fr_ret;
+    for (y = 0; y < fr_map_y; y++) {
+        if (cone_span_left(y) == 0xff)
+            continue;
+        mptr = fr_map_base + (y * fr_map_x) + cone_span_left(y);
+        for (x = cone_span_left(y); x <= cone_span_right(y); x++, mptr++) {
+            if (me_subclip(mptr) == SUBCLIP_OUT_OF_CONE)
+                continue;
+            if (!pvs_bit_tst(row, x + y * pvs_x))
+                me_subclip(mptr) = SUBCLIP_OUT_OF_CONE;
+            else {
+                dist = abs(x - _fr_x_cen) + abs(y - _fr_y_cen);
+                if (dist > far_dist)
+                    far_dist = dist;
+            }
+        }
+    }
+    if (far_dist < frpipe_dist)
+        frpipe_dist = far_dist;
+    _fr_ret;
+}
@@ -109,11 +109,13 @@ static int _fdt_wallid;         // current external wall id
 static g3s_phandle *_fdt_lcore; // left core for external walls
 static g3s_phandle *_fdt_rcore; // right core for external walls
 static int _fdt_rbase;          // value of pbase at right of external walls, we use pbase itself for left
+static int _fdt_lbase;          // and at the left, since pbase gets moved to rbase partway through a wall
 static int _fdt_me_flags;       // hold store the current map flags
 static int _fdt_wmap;           // current tmap family to use
 static sfix _fdt_slock;         // sfix value for vlock in square
 
 int _fdt_pbase; // where pbase is, for corner for idx lookup - sadly global for object lighting
+static int x_mod[] = {0, 0, 1, 1}, y_mod[] = {0, 1, 1, 0}; // map offset of each pbase corner
 
 static uchar last_csp_fr = 0; // last frame annoyance
 static uchar _fdt_flip;       // tile flippitude of cur tile
@@ -199,9 +201,17 @@ void fr_tfunc_grab_fast(int mask);
 // and i...  dont want to know if you are lonely
 
 // hmm.. have to deal with halve points and such
+// project the finished point now, so every later user of the cached copy gets it for free
+static void _fr_cache_pt(g3s_phandle tmp, g3s_phandle slot) {
+    if ((tmp->codes & CC_BEHIND) == 0)
+        g3_project_point(tmp);
+    *slot = *tmp;
+}
+
 void _fr_figure_pt(g3s_phandle tmp, int pt_code) {
-    g3s_phandle *core;
+    g3s_phandle *core, slot = NULL;
     pt_mods *ptm;
+    uchar hit;
 
     ptm = &pt_deref[pt_code & FRPTSPTOFF];
     switch (_fdt_pbase = ptm->base) { // bad bad bad - hmmm... arrays?
@@ -225,6 +235,14 @@ void _fr_figure_pt(g3s_phandle tmp, int pt_code) {
     _fdt_whichpt = ((pt_code & FRPTSZMASK) >> FRPTSZSHF);
     _fdt_hgt_pt = _fdt_hgts[_fdt_whichpt + 1];
     _fdt_hgt_val = _fr_fhgt_list[_fdt_hgt_pt];
+    if (_fdt_terr) { // neighbours share corners, so see if one of them already did this point
+        slot = fr_pts_cache_slot(_fdt_x + x_mod[_fdt_pbase], _fdt_y + y_mod[_fdt_pbase], -_fdt_hgt_val, ptm->modcnt,
+                                 (ptm->modcnt == FRMODNONE) ? 0 : ptm->arg, &hit);
+        if (hit) {
+            *tmp = *slot;
+            return;
+        }
+    }
     g3_replace_add_delta_y(*core, tmp, -_fdt_hgt_val);
     switch (ptm->modcnt) { // 1 function table
     case FRMODYAXIS:
@@ -236,6 +254,22 @@ void _fr_figure_pt(g3s_phandle tmp, int pt_code) {
     case FRMODNONE:
         break;
     }
+    if (_fdt_terr)
+        _fr_cache_pt(tmp, slot);
+}
+
+// external walls build their points right off the core, with a raw height
+static void _fr_ext_pt(g3s_phandle core, int base, g3s_phandle tmp, fix dy) {
+    g3s_phandle slot;
+    uchar hit;
+
+    slot = fr_pts_cache_slot(_fdt_x + x_mod[base], _fdt_y + y_mod[base], dy, FRMODNONE, 0, &hit);
+    if (hit)
+        *tmp = *slot;
+    else {
+        g3_replace_add_delta_y(core, tmp, dy);
+        _fr_cache_pt(tmp, slot);
+    }
 }
 
 fix get_light(fix dist_to) // , fix dot_prod)
@@ -333,20 +367,69 @@ int _fr_do_light_val(int which, fix dist_val) {
     //   return wrk->i;
 }
 
+// corner light cache, a corner gets lit for the floor, the ceiling and every wall touching it,
+// so remember the answer for the rest of the view.  the stamp moves on each view and whenever
+// someone tells us the lights changed, which empties the whole thing at once
+#define LGT_CACHE_SIZE 512
+typedef struct {
+    uint stamp;
+    short x, y;
+    fix hgt;
+    MapElem *mp;
+    uchar ceil;
+    int i;
+} lgt_cache_ent;
+static lgt_cache_ent lgt_cache[LGT_CACHE_SIZE];
+static uint lgt_stamp = 1;
+int fr_lgt_cache_hits = 0, fr_lgt_cache_misses = 0;
+
+void fr_light_changed(void) {
+    if (++lgt_stamp == 0) {
+        LG_memset(lgt_cache, 0, sizeof(lgt_cache));
+        lgt_stamp = 1;
+    }
+}
+
+int fr_light_cache_stats(void) {
+    int tot = fr_lgt_cache_hits + fr_lgt_cache_misses, pct = 0;
+    if (tot > 0)
+        pct = (fr_lgt_cache_hits * 100) / tot;
+    DEBUG("%s: %d hits %d misses (%d%%)", __FUNCTION__, fr_lgt_cache_hits, fr_lgt_cache_misses, pct);
+    fr_lgt_cache_hits = fr_lgt_cache_misses = 0;
+    return pct;
+}
+
 int _fr_do_light(g3s_phandle wrk, int which) {
     //   fix dval=abs(wrk->x)+abs(wrk->y)+abs(wrk->z));
     //   fix dval=fix_fast_pyth_dist(fix_fast_pyth_dist(wrk->x,wrk->y),wrk->z);
     // really, we want the original, not transformed, points
     // how bout this mess, eh?
-    static int x_mod[] = {0, 0, 1, 1}, y_mod[] = {0, 1, 1, 0};
     int _lgt_x, _lgt_y;
     fix dval;
+    lgt_cache_ent *ent;
+    MapElem *our_mp = _fdt_mptr + csp_trans_add[_fdt_pbase];
+    uchar ceil = (which == FRPTSZCEIL_DN);
+
     _lgt_x = _fdt_x + x_mod[_fdt_pbase];
     _lgt_y = _fdt_y + y_mod[_fdt_pbase];
+    ent = &lgt_cache[((_lgt_x * 37) + (_lgt_y * 101) + (_fdt_hgt_val >> 12) + ceil) & (LGT_CACHE_SIZE - 1)];
+    if ((ent->stamp == lgt_stamp) && (ent->x == _lgt_x) && (ent->y == _lgt_y) && (ent->hgt == _fdt_hgt_val) &&
+        (ent->ceil == ceil) && (ent->mp == our_mp)) {
+        fr_lgt_cache_hits++;
+        return wrk->i = ent->i;
+    }
+    fr_lgt_cache_misses++;
     dval =
         fix_fast_pyth_dist(fix_fast_pyth_dist((_lgt_x << 16) - fr_camera_last[0], (_lgt_y << 16) - fr_camera_last[1]),
                            fr_camera_last[2] - _fdt_hgt_val);
     wrk->i = _fr_do_light_val(which, dval);
+    ent->stamp = lgt_stamp;
+    ent->x = _lgt_x;
+    ent->y = _lgt_y;
+    ent->hgt = _fdt_hgt_val;
+    ent->mp = our_mp;
+    ent->ceil = ceil;
+    ent->i = wrk->i;
     return wrk->i;
 }
 
@@ -598,31 +681,31 @@ static void _fr_null_ext_wall(fix pt_list[4][2]) {}
 
 static void _fr_flat_ext_wall(
     fix pt_list[4][2]) { // note we do this out of order so we can have left left right right, ie. note their indicies
-    g3_replace_add_delta_y(*_fdt_lcore, _fdt_tmppts[0], -pt_list[0][1]);
-    g3_replace_add_delta_y(*_fdt_lcore, _fdt_tmppts[3], -pt_list[3][1]);
+    _fr_ext_pt(*_fdt_lcore, _fdt_lbase, _fdt_tmppts[0], -pt_list[0][1]);
+    _fr_ext_pt(*_fdt_lcore, _fdt_lbase, _fdt_tmppts[3], -pt_list[3][1]);
     _fdt_pbase = _fdt_rbase;
-    g3_replace_add_delta_y(*_fdt_rcore, _fdt_tmppts[1], -pt_list[1][1]);
-    g3_replace_add_delta_y(*_fdt_rcore, _fdt_tmppts[2], -pt_list[2][1]);
+    _fr_ext_pt(*_fdt_rcore, _fdt_rbase, _fdt_tmppts[1], -pt_list[1][1]);
+    _fr_ext_pt(*_fdt_rcore, _fdt_rbase, _fdt_tmppts[2], -pt_list[2][1]);
     _fr_ndbg(NO_REND, g3_draw_poly((*fr_get_idx)(), 4, _fdt_tmppts));
     _fr_sdbg(STATS, _frp.stats.ext_wall++);
 }
 
 #ifdef FLAT_SUPPORT
 static void _fr_flat_lit_ext_wall(fix pt_list[4][2]) {
-    g3_replace_add_delta_y(*_fdt_lcore, _fdt_tmppts[0], -pt_list[0][1]);
+    _fr_ext_pt(*_fdt_lcore, _fdt_lbase, _fdt_tmppts[0], -pt_list[0][1]);
     _fdt_hgt_val = -pt_list[0][1];
     _fr_do_light(_fdt_tmppts[0], dlC);
     _fdt_tmppts[0]->p3_flags |= PF_I;
-    g3_replace_add_delta_y(*_fdt_lcore, _fdt_tmppts[3], -pt_list[3][1]);
+    _fr_ext_pt(*_fdt_lcore, _fdt_lbase, _fdt_tmppts[3], -pt_list[3][1]);
     _fdt_hgt_val = -pt_list[3][1];
     _fr_do_light(_fdt_tmppts[3], dlF);
     _fdt_tmppts[3]->p3_flags |= PF_I;
     _fdt_pbase = _fdt_rbase;
-    g3_replace_add_delta_y(*_fdt_rcore, _fdt_tmppts[1], -pt_list[1][1]);
+    _fr_ext_pt(*_fdt_rcore, _fdt_rbase, _fdt_tmppts[1], -pt_list[1][1]);
     _fdt_hgt_val = -pt_list[1][1];
     _fr_do_light(_fdt_tmppts[1], dlC);
     _fdt_tmppts[1]->p3_flags |= PF_I;
-    g3_replace_add_delta_y(*_fdt_rcore, _fdt_tmppts[2], -pt_list[2][1]);
+    _fr_ext_pt(*_fdt_rcore, _fdt_rbase, _fdt_tmppts[2], -pt_list[2][1]);
     _fdt_hgt_val = -pt_list[2][1];
     _fr_do_light(_fdt_tmppts[2], dlF);
     _fdt_tmppts[2]->p3_flags |= PF_I;
@@ -635,14 +718,14 @@ static void _fr_flat_lit_ext_wall(fix pt_list[4][2]) {
 #endif
 
 static void _fr_tmap_ext_wall(fix pt_list[4][2]) {
-    g3_replace_add_delta_y(*_fdt_lcore, _fdt_tmppts[0], -pt_list[0][1]);
+    _fr_ext_pt(*_fdt_lcore, _fdt_lbase, _fdt_tmppts[0], -pt_list[0][1]);
     ext_wall_uv_l(_fdt_tmppts[0], pt_list[0]);
-    g3_replace_add_delta_y(*_fdt_lcore, _fdt_tmppts[3], -pt_list[3][1]);
+    _fr_ext_pt(*_fdt_lcore, _fdt_lbase, _fdt_tmppts[3], -pt_list[3][1]);
     ext_wall_uv_l(_fdt_tmppts[3], pt_list[3]);
     _fdt_pbase = _fdt_rbase;
-    g3_replace_add_delta_y(*_fdt_rcore, _fdt_tmppts[1], -pt_list[1][1]);
+    _fr_ext_pt(*_fdt_rcore, _fdt_rbase, _fdt_tmppts[1], -pt_list[1][1]);
     ext_wall_uv_r(_fdt_tmppts[1], pt_list[1]);
-    g3_replace_add_delta_y(*_fdt_rcore, _fdt_tmppts[2], -pt_list[2][1]);
+    _fr_ext_pt(*_fdt_rcore, _fdt_rbase, _fdt_tmppts[2], -pt_list[2][1]);
     ext_wall_uv_r(_fdt_tmppts[2], pt_list[2]);
     if (quik_draw_tmap_p(4)) {
         _fr_ndbg(NO_REND, _fr_wall_func(4, _fdt_tmppts, (*fr_get_tmap)()));
@@ -651,20 +734,20 @@ static void _fr_tmap_ext_wall(fix pt_list[4][2]) {
 }
 
 static void _fr_tmap_lit_ext_wall(fix pt_list[4][2]) {
-    g3_replace_add_delta_y(*_fdt_lcore, _fdt_tmppts[0], -pt_list[0][1]);
+    _fr_ext_pt(*_fdt_lcore, _fdt_lbase, _fdt_tmppts[0], -pt_list[0][1]);
     ext_wall_uv_l_i(_fdt_tmppts[0], pt_list[0]);
     _fdt_hgt_val = pt_list[0][1];
     _fr_do_light(_fdt_tmppts[0], dlC);
-    g3_replace_add_delta_y(*_fdt_lcore, _fdt_tmppts[3], -pt_list[3][1]);
+    _fr_ext_pt(*_fdt_lcore, _fdt_lbase, _fdt_tmppts[3], -pt_list[3][1]);
     ext_wall_uv_l_i(_fdt_tmppts[3], pt_list[3]);
     _fdt_hgt_val = pt_list[3][1];
     _fr_do_light(_fdt_tmppts[3], dlF);
     _fdt_pbase = _fdt_rbase;
-    g3_replace_add_delta_y(*_fdt_rcore, _fdt_tmppts[1], -pt_list[1][1]);
+    _fr_ext_pt(*_fdt_rcore, _fdt_rbase, _fdt_tmppts[1], -pt_list[1][1]);
     ext_wall_uv_r_i(_fdt_tmppts[1], pt_list[1]);
     _fdt_hgt_val = pt_list[1][1];
     _fr_do_light(_fdt_tmppts[1], dlC);
-    g3_replace_add_delta_y(*_fdt_rcore, _fdt_tmppts[2], -pt_list[2][1]);
+    _fr_ext_pt(*_fdt_rcore, _fdt_rbase, _fdt_tmppts[2], -pt_list[2][1]);
     ext_wall_uv_r_i(_fdt_tmppts[2], pt_list[2]);
     _fdt_hgt_val = pt_list[2][1];
     _fr_do_light(_fdt_tmppts[2], dlF);
@@ -675,28 +758,28 @@ static void _fr_tmap_lit_ext_wall(fix pt_list[4][2]) {
 }
 
 static void _fr_cspace_wire_ext_wall(fix pt_list[4][2]) {
-    g3_replace_add_delta_y(*_fdt_lcore, _fdt_tmppts[0], -pt_list[0][1]);
+    _fr_ext_pt(*_fdt_lcore, _fdt_lbase, _fdt_tmppts[0], -pt_list[0][1]);
     _fr_do_cspace(_fdt_tmppts[0], dlC);
-    g3_replace_add_delta_y(*_fdt_lcore, _fdt_tmppts[3], -pt_list[3][1]);
+    _fr_ext_pt(*_fdt_lcore, _fdt_lbase, _fdt_tmppts[3], -pt_list[3][1]);
     _fr_do_cspace(_fdt_tmppts[3], dlF);
     _fdt_pbase = _fdt_rbase;
-    g3_replace_add_delta_y(*_fdt_rcore, _fdt_tmppts[1], -pt_list[1][1]);
+    _fr_ext_pt(*_fdt_rcore, _fdt_rbase, _fdt_tmppts[1], -pt_list[1][1]);
     _fr_do_cspace(_fdt_tmppts[1], dlC);
-    g3_replace_add_delta_y(*_fdt_rcore, _fdt_tmppts[2], -pt_list[2][1]);
+    _fr_ext_pt(*_fdt_rcore, _fdt_rbase, _fdt_tmppts[2], -pt_list[2][1]);
     _fr_do_cspace(_fdt_tmppts[2], dlF);
     _fr_ndbg(NO_REND, _fr_draw_wire_cpoly_4());
     _fr_sdbg(STATS, _frp.stats.ext_wall++);
 }
 
 static void _fr_cspace_full_ext_wall(fix pt_list[4][2]) {
-    g3_replace_add_delta_y(*_fdt_lcore, _fdt_tmppts[0], -pt_list[0][1]);
+    _fr_ext_pt(*_fdt_lcore, _fdt_lbase, _fdt_tmppts[0], -pt_list[0][1]);
     _fr_do_cspace(_fdt_tmppts[0], dlC);
-    g3_replace_add_delta_y(*_fdt_lcore, _fdt_tmppts[3], -pt_list[3][1]);
+    _fr_ext_pt(*_fdt_lcore, _fdt_lbase, _fdt_tmppts[3], -pt_list[3][1]);
     _fr_do_cspace(_fdt_tmppts[3], dlF);
     _fdt_pbase = _fdt_rbase;
-    g3_replace_add_delta_y(*_fdt_rcore, _fdt_tmppts[1], -pt_list[1][1]);
+    _fr_ext_pt(*_fdt_rcore, _fdt_rbase, _fdt_tmppts[1], -pt_list[1][1]);
     _fr_do_cspace(_fdt_tmppts[1], dlC);
-    g3_replace_add_delta_y(*_fdt_rcore, _fdt_tmppts[2], -pt_list[2][1]);
+    _fr_ext_pt(*_fdt_rcore, _fdt_rbase, _fdt_tmppts[2], -pt_list[2][1]);
     _fr_do_cspace(_fdt_tmppts[2], dlF);
     _fr_ndbg(NO_REND, g3_draw_cpoly(4, _fdt_tmppts));
     _fr_sdbg(STATS, _frp.stats.ext_wall++);
@@ -1166,7 +1249,7 @@ void _render_3d_walls(int which, int cnt) {
     _fdt_wallid = which;
     flip_setup(which);
 
-    switch (_fdt_pbase = pt_deref[(wpt->ul & FRPTSPTOFF)].base) {
+    switch (_fdt_lbase = _fdt_pbase = pt_deref[(wpt->ul & FRPTSPTOFF)].base) {
     case 0:
         _fdt_lcore = _fr_ptbase;
         break;
@@ -1613,6 +1696,7 @@ void fr_terr_frame_start(void) {
 
     last_csp_fr = 0; // initially no filled mode
     _fdt_terr = TRUE;
+    fr_light_changed(); // new camera, so all the corner light distances are new
 }
 
 void fr_terr_frame_end(void) {
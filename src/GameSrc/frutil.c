@@ -37,6 +37,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "frintern.h"
 #include "frparams.h"
 #include "frflags.h"
+#include "textmaps.h"
 
 uchar fr_cur_obj_col;
 ushort fr_col_to_obj[256];
@@ -68,6 +69,14 @@ char *fr_get_frame_rate(void) {
     _frp.time.last_chk_time = *tmd_ticks;
 
     INFO("%s", fr_str);
+    fr_pts_cache_stats();
+    fr_light_cache_stats();
+    {
+        long hits, misses, bytes;
+        gr_rsd8_cache_stats(&hits, &misses, &bytes, TRUE);
+        DEBUG("%s: rsd unpack cache %ld hits %ld misses, %ld bytes", __FUNCTION__, hits, misses, bytes);
+    }
+    textures_stats();
     return fr_str;
 }
 
@@ -52,6 +52,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "textmaps.h"
 #include "tools.h"
 #include "wares.h"
+#include "retain.h"
 
 #include "game_screen.h" // was screen.h?
 #include "Shock.h"
@@ -228,6 +229,8 @@ void change_svga_screen_mode() {
     uchar mode_change = FALSE;
     short temp;
 
+    // new canvases, or a new layout: nothing the panels left up is still there
+    retain_invalidate_all();
     if (convert_use_mode != mode_id)
         mode_change = TRUE;
     if (mode_change) {
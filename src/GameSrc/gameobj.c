@@ -62,6 +62,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "objload.h"
 
 #include "ai.h"
+#include "effect.h"
 
 #ifdef DOOM_EMULATION_MODE
 #include "diffq.h"
@@ -661,9 +662,12 @@ short compute_3drep(Obj *cobj, ObjID cobjid, int obj_type) {
         int d2 = objBigstuffs[cobj->specID].data2;
         if (d2 & INDIRECTED_STUFF_INDICATOR_MASK) {
             ObjID newid = d2 & INDIRECTED_STUFF_DATA_MASK;
+            anim_catch_up(newid);
             o3drep = objBigstuffs[objs[newid].specID].data2 + objs[newid].info.current_frame;
-        } else
+        } else {
+            anim_catch_up(cobjid);
             o3drep = objBigstuffs[cobj->specID].data2 + cobj->info.current_frame;
+        }
     } else {
         switch (obj_type) {
         case FAUBJ_TPOLY:
@@ -1001,7 +1005,10 @@ void show_obj(ObjID cobjid) {
                     uchar line, *srcp, *dstp, *trgp;
                     tpdata = get_critter_bitmap_fast(cobjid, ID2TRIP(cobjid), get_crit_posture(_fr_cobj->specID), 0,
                                                      (ubyte)view, &ref, &anch);
-                    gr_rsd8_convert(tpdata, &tpdata_temp);
+                    if (gr_rsd8_cache_convert(tpdata, &tpdata_temp) != GR_UNPACK_RSD8_OK) {
+                        release_critter_bitmap_fast(ref);
+                        return;
+                    }
                     tpdata = &tpdata_temp;
                     LG_memcpy(&tele_bm, tpdata, sizeof(grs_bitmap));
                     tele_bm.bits = big_buffer + 32768;
@@ -1014,6 +1021,7 @@ void show_obj(ObjID cobjid) {
                             *dstp = TELEPORT_COLOR + (rand() & 0x3);
                     trgp = tpdata->bits + tele_bm.h * tele_bm.w;
                     LG_memcpy(dstp, srcp, trgp - srcp);
+                    gr_rsd8_cache_release(&tpdata_temp);
 
                     _fr_draw_bitmap(&tele_bm, _fdt_dist, FALSE, anch.ul.x, anch.ul.y);
                     release_critter_bitmap_fast(ref);
@@ -1029,14 +1037,17 @@ void show_obj(ObjID cobjid) {
 #ifdef TLUC_IN_2D
                 tpdata->flags |= BMF_TLUC8;
 #else
-                gr_rsd8_convert(tpdata, &tpdata_temp);
-                tpdata = &tpdata_temp;
-                tpdata->type = BMT_TLUC8;
+                if (gr_rsd8_cache_convert(tpdata, &tpdata_temp) == GR_UNPACK_RSD8_OK) {
+                    tpdata = &tpdata_temp;
+                    tpdata->type = BMT_TLUC8;
+                }
 #endif
 #endif
                 break;
             }
             _fr_draw_bitmap(tpdata, _fdt_dist, 0, anch.ul.x, anch.ul.y);
+            if (tpdata == &tpdata_temp)
+                gr_rsd8_cache_release(&tpdata_temp);
             release_critter_bitmap_fast(ref);
         } else {
             tpdata = bitmaps_3d[o3drep + view];
@@ -1044,7 +1055,7 @@ void show_obj(ObjID cobjid) {
         }
     } break;
 
-    case FAUBJ_VOX: { // wait, cant we just keep vvv around, and stuff the two bitmaps, w+h each time, save some here
+    case FAUBJ_VOX: { // vvv is cheap, the vox library keeps the dot lists for the bitmaps between frames
         vxs_vox vvv;
         fix damage_factor = fix_div(fix_make(_fr_cobj->info.current_hp, 0), fix_make(ObjProps[objtrip].hit_points, 0));
         fix pdist = VOXEL_PIX_DIST_BASE;
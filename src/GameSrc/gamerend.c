@@ -71,7 +71,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "audiolog.h"
 #endif
 
-extern uchar tmap_big_buffer[];
+extern uchar *tmap_big_buffer;
 
 // prototypes
 void set_shield_raisage(uchar going_up);
@@ -17,12 +17,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 */
 
+#include <stdlib.h>
+#include <string.h>
 #include "cit2d.h"
 #include "gr2ss.h"
 #include "frtypes.h"
 #include "frintern.h"
 #include "frprotox.h"
 #include "gamescr.h"
+#include "res.h"
 
 //Â¥Â¥#include <inp6d.h>
 
@@ -190,6 +193,147 @@ void ss_string(char *s, short x, short y) {
     }
 }
 
+// Scaled copies of bitmaps.  The UI art goes up at the same size over and
+//  over, so each bitmap is scaled once to the size it's drawn at and put down
+//  from that copy after, which comes out the same to the pixel.  Keyed by the
+//  source bits and shape, and thrown out when resources move or the mode
+//  changes.  A flat source can be a canvas that gets drawn into, so what it
+//  looked like is kept and checked too, and one that changes every time it's
+//  drawn is just scaled every time.
+
+#define SS_SCALED_CNT 128
+
+typedef struct {
+    uchar *src; // source bits, NULL for a free slot
+    short w, h, row;
+    uchar type, flags;
+    uint gen;        // resGeneration when scaled
+    uchar *copy;     // a flat source's pixels, w x h
+    uchar changed;   // times in a row a flat source was found changed
+    uchar dirty;     // bm is older than copy
+    ulong last_used; // for lru
+    grs_bitmap bm;   // the scaled copy, with copy after it
+    uint *runs;      // bm's opaque runs, if it's transparent
+} ss_scaled_ent;
+
+static ss_scaled_ent ss_scaled[SS_SCALED_CNT];
+static ulong ss_scaled_stamp = 0;
+static char ss_scaled_mode = -1;
+
+static void ss_scaled_free(ss_scaled_ent *e) {
+    free(e->bm.bits);
+    free(e->runs);
+    memset(e, 0, sizeof(ss_scaled_ent));
+}
+
+// is a flat source still what it was, and if not make it so
+static uchar ss_scaled_check(ss_scaled_ent *e, grs_bitmap *bmp) {
+    uchar *s, *c;
+    int y;
+
+    for (y = 0, s = bmp->bits, c = e->copy; y < e->h; y++, s += e->row, c += e->w)
+        if (memcmp(c, s, e->w) != 0)
+            break;
+    if (y == e->h)
+        return TRUE;
+    for (; y < e->h; y++, s += e->row, c += e->w)
+        memcpy(c, s, e->w);
+    return FALSE;
+}
+
+static uchar ss_scaled_draw(ss_scaled_ent *e, grs_bitmap *bmp) {
+    grs_canvas cnv;
+
+    gr_make_canvas(&e->bm, &cnv);
+    gr_push_canvas(&cnv);
+    gr_clear(0);
+    gr_scale_bitmap(bmp, 0, 0, e->bm.w, e->bm.h);
+    gr_pop_canvas();
+    e->dirty = FALSE;
+    if (e->bm.flags & BMF_TRANS) {
+        free(e->runs);
+        if ((e->runs = (uint *)malloc(gr_sprite_runs_size(&e->bm))) == NULL)
+            return FALSE;
+        gr_sprite_runs_make(&e->bm, e->runs);
+    }
+    return TRUE;
+}
+
+// bmp scaled to w x h, or NULL if it has to be scaled as it's drawn
+static ss_scaled_ent *ss_get_scaled(grs_bitmap *bmp, short w, short h) {
+    ss_scaled_ent *e, *use = NULL;
+    int i, n;
+    uchar *s, *c;
+
+    if ((w <= 0) || (h <= 0) || (grd_bm.type != BMT_FLAT8) || (gr_get_fill_type() != FILL_NORM))
+        return NULL;
+    if ((bmp->type != BMT_FLAT8) && (bmp->type != BMT_RSD8))
+        return NULL;
+    if (ss_scaled_mode != convert_use_mode) {
+        for (i = 0; i < SS_SCALED_CNT; i++)
+            ss_scaled_free(&ss_scaled[i]);
+        ss_scaled_mode = convert_use_mode;
+    }
+
+    for (i = 0; i < SS_SCALED_CNT; i++) {
+        e = &ss_scaled[i];
+        if ((e->src != NULL) && (e->gen != resGeneration))
+            ss_scaled_free(e); // stale, the source may not even be there any more
+        if ((e->src == bmp->bits) && (e->w == bmp->w) && (e->h == bmp->h) && (e->row == bmp->row) &&
+            (e->type == bmp->type) && (e->flags == bmp->flags) && (e->bm.w == w) && (e->bm.h == h)) {
+            e->last_used = ++ss_scaled_stamp;
+            if ((e->copy != NULL) && !ss_scaled_check(e, bmp)) {
+                e->dirty = TRUE;
+                if (++e->changed > 1)
+                    return NULL;
+            } else
+                e->changed = 0;
+            if (e->dirty && !ss_scaled_draw(e, bmp)) {
+                ss_scaled_free(e);
+                return NULL;
+            }
+            return e;
+        }
+        if ((use == NULL) || (e->src == NULL) || ((use->src != NULL) && (e->last_used < use->last_used)))
+            use = e;
+    }
+
+    ss_scaled_free(use);
+    n = (bmp->type == BMT_FLAT8) ? bmp->w * bmp->h : 0;
+    if ((s = (uchar *)malloc(w * h + n)) == NULL)
+        return NULL;
+    gr_init_bm(&use->bm, s, BMT_FLAT8, bmp->flags & BMF_TRANS, w, h);
+    if (n != 0) {
+        use->copy = s + w * h;
+        for (i = 0, s = bmp->bits, c = use->copy; i < bmp->h; i++, s += bmp->row, c += bmp->w)
+            memcpy(c, s, bmp->w);
+    }
+    if (!ss_scaled_draw(use, bmp)) {
+        ss_scaled_free(use);
+        return NULL;
+    }
+    use->src = bmp->bits;
+    use->w = bmp->w;
+    use->h = bmp->h;
+    use->row = bmp->row;
+    use->type = bmp->type;
+    use->flags = bmp->flags;
+    use->gen = resGeneration;
+    use->last_used = ++ss_scaled_stamp;
+    return use;
+}
+
+// bmp scaled into x,y,w,h from its scaled copy, through cl if that's not
+//  NULL, or FALSE if it has to be done the slow way
+static uchar ss_put_scaled(grs_bitmap *bmp, short x, short y, short w, short h, uchar *cl) {
+    ss_scaled_ent *e = ss_get_scaled(bmp, w, h);
+
+    if (e == NULL)
+        return FALSE;
+    gr_scale_sprite(&e->bm, e->runs, fix_make(x, 0), fix_make(y, 0), fix_make(x + w, 0), fix_make(y + h, 0), cl);
+    return TRUE;
+}
+
 void ss_bitmap(grs_bitmap *bmp, short x, short y) {
     uchar rv;
     if (rv = perform_svga_conversion(OVERRIDE_SCALE)) {
@@ -208,16 +352,18 @@ void ss_bitmap(grs_bitmap *bmp, short x, short y) {
             gr_pop_canvas();
         } else
 #endif
-            gr_scale_bitmap(bmp, SCONV_X(x), SCONV_Y(y), SCONV_X(bmp->w), SCONV_Y(bmp->h));
+            if (!ss_put_scaled(bmp, SCONV_X(x), SCONV_Y(y), SCONV_X(bmp->w), SCONV_Y(bmp->h), NULL))
+                gr_scale_bitmap(bmp, SCONV_X(x), SCONV_Y(y), SCONV_X(bmp->w), SCONV_Y(bmp->h));
         //      Warning(("scaling %d x %d to %d x %d\n",bmp->w,bmp->h,SCONV_X(bmp->w),SCONV_Y(bmp->h)));
     } else
         gr_bitmap(bmp, x, y);
 }
 
 void ss_ubitmap(grs_bitmap *bmp, short x, short y) {
-    if (perform_svga_conversion(OVERRIDE_SCALE))
-        gr_scale_ubitmap(bmp, SCONV_X(x), SCONV_Y(y), SCONV_X(bmp->w), SCONV_Y(bmp->h));
-    else
+    if (perform_svga_conversion(OVERRIDE_SCALE)) {
+        if (!ss_put_scaled(bmp, SCONV_X(x), SCONV_Y(y), SCONV_X(bmp->w), SCONV_Y(bmp->h), NULL))
+            gr_scale_ubitmap(bmp, SCONV_X(x), SCONV_Y(y), SCONV_X(bmp->w), SCONV_Y(bmp->h));
+    } else
         gr_ubitmap(bmp, x, y);
 }
 
@@ -245,9 +391,10 @@ void ss_noscale_bitmap(grs_bitmap *bmp, short x, short y) {
 }
 
 void ss_scale_bitmap(grs_bitmap *bmp, short x, short y, short w, short h) {
-    if (perform_svga_conversion(OVERRIDE_SCALE))
-        gr_scale_bitmap(bmp, SCONV_X(x), SCONV_Y(y), SCONV_X(w), SCONV_Y(h));
-    else
+    if (perform_svga_conversion(OVERRIDE_SCALE)) {
+        if (!ss_put_scaled(bmp, SCONV_X(x), SCONV_Y(y), SCONV_X(w), SCONV_Y(h), NULL))
+            gr_scale_bitmap(bmp, SCONV_X(x), SCONV_Y(y), SCONV_X(w), SCONV_Y(h));
+    } else
         gr_scale_bitmap(bmp, x, y, w, h);
 }
 
@@ -412,9 +559,10 @@ void ss_set_thick_pixel(long color, short x, short y) {
 }
 
 void ss_clut_ubitmap(grs_bitmap *bmp, short x, short y, uchar *cl) {
-    if (perform_svga_conversion(OVERRIDE_SCALE))
-        gr_clut_scale_ubitmap(bmp, SCONV_X(x), SCONV_Y(y), SCONV_X(bmp->w), SCONV_Y(bmp->h), cl);
-    else
+    if (perform_svga_conversion(OVERRIDE_SCALE)) {
+        if (!ss_put_scaled(bmp, SCONV_X(x), SCONV_Y(y), SCONV_X(bmp->w), SCONV_Y(bmp->h), cl))
+            gr_clut_scale_ubitmap(bmp, SCONV_X(x), SCONV_Y(y), SCONV_X(bmp->w), SCONV_Y(bmp->h), cl);
+    } else
         gr_clut_ubitmap(bmp, x, y, cl);
 }
 
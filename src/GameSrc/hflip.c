@@ -24,7 +24,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
 #include "gr2ss.h"
-#include "cybmem.h"
 
 // MLA #define REAL_HFLIP
 #ifdef REAL_HFLIP
@@ -95,19 +94,29 @@ void shock_hflip_in_place(grs_bitmap *bm) {
 
 void _flip_in_place(uchar *bits, uchar *tmp, int w, int h, int row) { do_flip_in_place(bits, tmp, w, h, row - w); }
 
-#else // !REAL_HFLIP
+#endif // REAL_HFLIP
 
-void shock_hflip_in_place(grs_bitmap *bm) {
-    grs_canvas big_canvas;
-    grs_canvas bm_canvas;
-    gr_init_canvas(&big_canvas, big_buffer, BMT_FLAT8, bm->w, bm->h);
-    gr_init_canvas(&bm_canvas, bm->bits, BMT_FLAT8, bm->w, bm->h);
-    gr_push_canvas(&big_canvas);
+extern uchar perform_svga_conversion(uchar mask);
+
+// draw bm mirrored left to right at x,y.  the hflip blitters read each row
+// backwards, so bm itself (usually resource memory) is never written.
+void shock_hflip_bitmap(grs_bitmap *bm, short x, short y) {
+    grs_canvas tmp_canvas;
+    uchar *tmp;
+
+    if (!perform_svga_conversion(OVERRIDE_SCALE)) {
+        gr_hflip_bitmap(bm, x, y);
+        return;
+    }
+    // the scalers have no mirrored mode, so mirror into scratch and scale that
+    if ((tmp = (uchar *)gr_alloc_temp(bm->w * bm->h)) == NULL)
+        return;
+    gr_init_canvas(&tmp_canvas, tmp, BMT_FLAT8, bm->w, bm->h);
+    gr_push_canvas(&tmp_canvas);
+    gr_clear(0);
     gr_hflip_bitmap(bm, 0, 0);
     gr_pop_canvas();
-    gr_push_canvas(&bm_canvas);
-    ss_bitmap(&big_canvas.bm, 0, 0);
-    gr_pop_canvas();
+    tmp_canvas.bm.flags |= bm->flags & BMF_TRANS;
+    ss_bitmap(&tmp_canvas.bm, x, y);
+    gr_free_temp(tmp);
 }
-
-#endif
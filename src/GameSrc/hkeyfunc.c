@@ -1181,6 +1181,7 @@ uchar clear_transient_lighting_func(short keycode, ulong context, void *data) {
             me_templight_ceil_set(pme, 0);
         }
     }
+    fr_light_changed();
     message_info("Trans. light cleared");
     return (FALSE);
 }
@@ -455,20 +455,17 @@ void update_damage_report(struct _hudobj_data *dat, uchar reverse) {
             x = (dat->xl + dat->xh - w) / 2;
             y = dat->yl - h;
             if (reverse) {
-                /*  shock_hflip_in_place is mostly ASM.
-                            extern void shock_hflip_in_place(grs_bitmap* bm);
-                            grs_canvas gc;
-                            grs_font* font = gr_get_font();
-                            gr_init_canvas(&gc,big_buffer,BMT_FLAT8,w+4,h+4);
-                            gr_push_canvas(&gc);
-                            gr_set_font(font);
-                            gr_clear(0);
-                            draw_shadowed_string(buf,2,2,TRUE);
-                            gr_pop_canvas();
-                            shock_hflip_in_place(&gc.bm);
-                            gc.bm.flags |= BMF_TRANS;
-                            ss_bitmap(&gc.bm,x-1,y-2);
-                */
+                extern void shock_hflip_bitmap(grs_bitmap *bm, short x, short y);
+                grs_canvas gc;
+                grs_font *font = gr_get_font();
+                gr_init_canvas(&gc, big_buffer, BMT_FLAT8, w + 4, h + 4);
+                gr_push_canvas(&gc);
+                gr_set_font(font);
+                gr_clear(0);
+                draw_shadowed_string(buf, 2, 2, TRUE);
+                gr_pop_canvas();
+                gc.bm.flags |= BMF_TRANS;
+                shock_hflip_bitmap(&gc.bm, x - 1, y - 2);
             } else {
 #ifdef SVGA_SUPPORT
                 extern uchar shadow_scale;
@@ -67,6 +67,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "game_screen.h"
 #include "shodan.h"
 #include "fullscrn.h"
+#include "framelim.h"
+#include "retain.h"
 #include "wares.h"
 #include "frcamera.h"
 #include "faketime.h"
@@ -222,6 +224,44 @@ extern void CitFree(void *p);
 #define PALETTE_SIZE 768
 uchar ppall[PALETTE_SIZE];
 
+// the rsd unpack cache keeps only bitmaps living in resources, and
+// is told when each one's memory goes away.  ResPtrId walks every
+// descriptor, and most of a frame's bitmaps come out of the same few
+// resources, so the last blocks a bitmap was found in get checked first
+#define RSD_OWNER_CNT 16
+static struct {
+    uchar *ptr;
+    int32_t size;
+} rsd_owners[RSD_OWNER_CNT];
+static int rsd_owner_next;
+
+static int rsd_cache_owner(void *bits) {
+    int i;
+    Id id;
+
+    for (i = 0; i < RSD_OWNER_CNT; i++)
+        if (((uchar *)bits >= rsd_owners[i].ptr) && ((uchar *)bits < rsd_owners[i].ptr + rsd_owners[i].size))
+            return TRUE;
+    if ((id = ResPtrId(bits)) == 0)
+        return FALSE;
+    rsd_owners[rsd_owner_next].ptr = (uchar *)ResPtr(id);
+    rsd_owners[rsd_owner_next].size = ResSize(id);
+    rsd_owner_next = (rsd_owner_next + 1) % RSD_OWNER_CNT;
+    return TRUE;
+}
+
+static void rsd_cache_res_mem(void *ptr, int32_t size, bool gone) {
+    int i;
+
+    if (gone)
+        for (i = 0; i < RSD_OWNER_CNT; i++)
+            if (rsd_owners[i].ptr == (uchar *)ptr) {
+                rsd_owners[i].ptr = NULL;
+                rsd_owners[i].size = 0;
+            }
+    gr_rsd8_cache_mem(ptr, size, gone);
+}
+
 //-------------------------------------------------
 //  Initialize everything!
 //-------------------------------------------------
@@ -284,6 +324,11 @@ void init_all(void) {
 
     // use it for rsd unpacking too....this might be fill'd with danger
     gr_set_unpack_buf(big_buffer);
+    gr_rsd8_cache_set_owner(rsd_cache_owner);
+    ResSetMemHook(rsd_cache_res_mem);
+
+    // panel redraw counts go out with the frame stats
+    framelim_report_func = retain_report;
 
     // set up temporary memory stuff
     temp_memstack.baseptr = big_buffer + sizeof(big_buffer) - TEMP_STACK_SIZE;
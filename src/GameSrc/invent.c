@@ -65,6 +65,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "gamescr.h"
 #include "amap.h"
 #include "citres.h"
+#include "retain.h"
 
 #include "game_screen.h" // was screen.h?
 
@@ -1957,6 +1958,35 @@ void draw_page_buttons(uchar full) {
     gr2ss_override = old_over;
 }
 
+// The page as it was last drawn is still up, and the list draw funcs only
+// ever redraw lines whose item, quantity or active state moved, so hashing
+// what they compare against says whether drawing the page would do anything.
+static retained_panel inventory_panel = RETAIN_PANEL("inventory");
+
+static ulong inventory_page_state(int pgnum) {
+    ulong hash = RETAIN_HASH_START;
+    inv_display *dpy;
+    int i;
+
+    hash = retain_hash_var(hash, pgnum);
+    hash = retain_hash_var(hash, full_game_3d);
+    hash = retain_hash_var(hash, player_struct.current_active);
+    hash = retain_hash_var(hash, show_all_actives);
+    hash = retain_hash(hash, player_struct.actives, sizeof(player_struct.actives));
+    hash = retain_hash(hash, known_actives, sizeof(known_actives));
+    for (i = 0; gen_inv_page(pgnum, &i, &dpy); i++) {
+        if (dpy->draw == draw_weapons_list) {
+            hash = retain_hash(hash, player_struct.weapons, sizeof(player_struct.weapons));
+            hash = retain_hash(hash, player_struct.cartridges, sizeof(player_struct.cartridges));
+            hash = retain_hash(hash, player_struct.partial_clip, sizeof(player_struct.partial_clip));
+        } else if (dpy->draw == draw_general_list)
+            hash = retain_hash(hash, player_struct.inventory, sizeof(player_struct.inventory));
+        else
+            hash = retain_hash(hash, (uchar *)&player_struct + dpy->offset, dpy->listlen);
+    }
+    return hash;
+}
+
 // ---------
 // EXTERNALS
 // ---------
@@ -2025,7 +2055,10 @@ errtype inventory_draw(void) {
 #ifdef SVGA_SUPPORT
     ss_set_hack_mode(2, &temp);
 #endif
-    inventory_draw_page(inventory_page);
+    if (full)
+        retain_drew(&inventory_panel);
+    if (full || retain_check(&inventory_panel, inventory_page_state(inventory_page)))
+        inventory_draw_page(inventory_page);
 #ifdef SVGA_SUPPORT
     ss_set_hack_mode(0, &temp);
     gr2ss_override = old_over;
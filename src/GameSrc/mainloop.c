@@ -51,6 +51,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <setup.h>
 #include <status.h>
 #include "cutsloop.h"
+#include "framelim.h"
+#include "autodet.h"
 
 /*
 #include <loopdbg.h>
@@ -155,6 +157,10 @@ void mainloop(int argc, char *argv[]) {
         SDLDraw();
 
         ZoomDrawProc(TRUE); //erase zoom rectangle if enabled; if not, returns immediately
+
+        framelim_frame_end();
+
+        autodet_between_frames();
     }
 
     cit_success = TRUE;
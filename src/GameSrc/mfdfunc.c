@@ -73,6 +73,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "gr2ss.h"
 #include "mfdgames.h"
 #include "shodan.h"
+#include "retain.h"
 
 #define MFD_SHIELD_FUNC 19
 
@@ -132,6 +133,7 @@ void draw_blank_mfd(void);
 void draw_mfd_item_spew(Ref id, int n);
 
 errtype mfd_item_init(MFD_Func *mfd);
+ulong mfd_item_state(MFD *m, ulong hash);
 void mfd_expose_blank(MFD *m, ubyte control);
 void mfd_item_expose(MFD *m, ubyte control);
 uchar mfd_item_handler(MFD *m, uiEvent *e);
@@ -152,6 +154,7 @@ errtype mfd_anim_init();
 void mfd_anim_expose(MFD *m, ubyte control);
 
 errtype mfd_weapon_init(MFD_Func *mfd);
+ulong mfd_weapon_state(MFD *m, ulong hash);
 void weapon_mfd_for_reload(void);
 void mfd_weapon_expose(MFD *m, ubyte control);
 uchar mfd_weapon_handler(MFD *m, uiEvent *e);
@@ -168,6 +171,8 @@ void mfd_setup_keypad(char special);
 
 uchar weapon_mfd_temp;
 
+errtype mfd_bioware_init(MFD_Func *f);
+ulong mfd_bioware_state(MFD *m, ulong hash);
 void mfd_bioware_expose(MFD *m, ubyte control);
 
 // ------------
@@ -328,9 +333,28 @@ errtype mfd_weapon_init(MFD_Func *mfd) {
     MfdBeamStatusRect.lr.x = MFD_BEAM_RECT_X2;
     MfdBeamStatusRect.lr.y = MFD_BEAM_RECT_Y2;
 
+    mfd->state = mfd_weapon_state;
     return OK;
 }
 
+// --------------------------------------------------------------------------
+// mfd_weapon_state()
+//
+// Everything mfd_weapon_expose() looks at when it isn't a full expose: the
+// current weapon's slot, the ammo counts on its buttons, and the beam slider.
+
+ulong mfd_weapon_state(MFD *m, ulong hash) {
+    ubyte w = player_struct.actives[ACTIVE_WEAPON];
+
+    hash = retain_hash_var(hash, w);
+    if (w != EMPTY_WEAPON_SLOT)
+        hash = retain_hash_var(hash, player_struct.weapons[w]);
+    hash = retain_hash(hash, player_struct.cartridges, sizeof(player_struct.cartridges));
+    hash = retain_hash(hash, player_struct.partial_clip, sizeof(player_struct.partial_clip));
+    hash = retain_hash_var(hash, in_or_out);
+    return retain_hash(hash, mfd_fdata[MFD_WEAPON_FUNC], sizeof(mfd_fdata[MFD_WEAPON_FUNC]));
+}
+
 // --------------------------------------------------------------------------
 // mfd_weapon_expose()
 //
@@ -970,9 +994,27 @@ errtype mfd_item_init(MFD_Func *mfd) {
     MfdGrenadeBox[1].lr.x = MFD_GRENADE_BOX_X2 + MFD_GRENADE_BOX_W;
     MfdGrenadeBox[1].lr.y = MFD_GRENADE_BOX_Y + MFD_GRENADE_BOX_H;
 
+    mfd->state = mfd_item_state;
     return OK;
 }
 
+// --------------------------------------------------------------------------
+// mfd_item_state()
+//
+// Everything mfd_item_expose() and the ammo page look at when it isn't a full
+// expose.  Ware effects and item use notify the item mfd far more often than
+// any of this changes.
+
+ulong mfd_item_state(MFD *m, ulong hash) {
+    hash = retain_hash(hash, player_struct.actives, sizeof(player_struct.actives));
+    hash = retain_hash(hash, player_struct.hardwarez, sizeof(player_struct.hardwarez));
+    hash = retain_hash(hash, player_struct.hardwarez_status, sizeof(player_struct.hardwarez_status));
+    hash = retain_hash(hash, player_struct.inventory, sizeof(player_struct.inventory));
+    hash = retain_hash(hash, player_struct.weapons, sizeof(player_struct.weapons));
+    hash = retain_hash(hash, player_struct.cartridges, sizeof(player_struct.cartridges));
+    return retain_hash(hash, mfd_fdata[MFD_ITEM_FUNC], sizeof(mfd_fdata[MFD_ITEM_FUNC]));
+}
+
 //--------------------------------------------------------------
 // Like mini-expose, but gets the name for you, and
 // conforms to our rect-o-tronic update facility
@@ -1944,6 +1986,35 @@ void mfd_grenade_expose(MFD *mfd, ubyte control) {
 
 #define BITS_PER_DRUG 2
 
+// ---------------------------------------------------------------------------
+// mfd_bioware_init()
+//
+// The bioware gets notified every frame by its ware effect, so it says what
+// it draws from, and doesn't get exposed again until some of that changes.
+
+errtype mfd_bioware_init(MFD_Func *f) {
+    f->state = mfd_bioware_state;
+    return OK;
+}
+
+// ---------------------------------------------------------------------------
+// mfd_bioware_state()
+//
+// Everything mfd_bioware_expose() looks at when it isn't a full expose.
+
+ulong mfd_bioware_state(MFD *m, ulong hash) {
+    int i;
+
+    for (i = 0; i < NUM_MFDS; i++)
+        hash = retain_hash_var(hash, player_struct.mfd_current_slots[i]);
+    hash = retain_hash_var(hash, player_struct.hardwarez[HARDWARE_BIOWARE]);
+    hash = retain_hash_var(hash, player_struct.hardwarez_status[HARDWARE_BIOWARE]);
+    hash = retain_hash_var(hash, player_struct.hit_points);
+    hash = retain_hash_var(hash, player_struct.fatigue);
+    hash = retain_hash(hash, player_struct.drug_status, sizeof(player_struct.drug_status));
+    return retain_hash(hash, &mfd_fdata[MFD_BIOWARE_FUNC][4 * m->id], 4);
+}
+
 void mfd_bioware_expose(MFD *m, ubyte control) {
     uchar full = control & MFD_EXPOSE_FULL;
     int i, y = 2, triple;
@@ -3159,13 +3230,13 @@ MFD_Func mfd_funcs[MFD_NUM_FUNCS] = {
     // MFD_MAP_FUNC     2
     {mfd_map_expose, mfd_map_handler, mfd_map_init, 20, MFD_INCREMENTAL},
     // MFD_TARGET_FUNC  3
-    {mfd_target_expose, mfd_target_handler, NULL, 21},
+    {mfd_target_expose, mfd_target_handler, mfd_target_init, 21},
     // MFD_ANIM_FUNC    4
     {mfd_expose_blank, NULL, NULL, 255},
     // MFD_WEAPON_FUNC  5
     {mfd_weapon_expose, mfd_weapon_handler, mfd_weapon_init, 25},
     // MFD_BIOWARE_FUNC 6
-    {mfd_bioware_expose, NULL, NULL, 50, MFD_NOSAVEREST},
+    {mfd_bioware_expose, NULL, mfd_bioware_init, 50, MFD_NOSAVEREST},
     // MFD_LANTERN_FUNC 7
     {mfd_lanternware_expose, NULL, mfd_lanternware_init, 38},
     // MFD_3DVIEW_FUNC  8
@@ -57,6 +57,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "popups.h"
 #include "statics.h"
 #include "gr2ss.h"
+#include "retain.h"
 //#include <inp6d.h>
 //#include <i6dvideo.h>
 
@@ -84,6 +85,7 @@ LGCursor mfd_bttn_cursors[NUM_MFDS];
 grs_bitmap mfd_bttn_bitmaps[NUM_MFDS];
 
 grs_canvas _offscreen_mfd, _fullscreen_mfd;
+retained_panel mfd_panels[NUM_MFDS] = {RETAIN_PANEL("left mfd"), RETAIN_PANEL("right mfd")};
 
 #define mfdL mfd[MFD_LEFT]
 #define mfdR mfd[MFD_RIGHT]
@@ -1123,6 +1125,20 @@ uchar mfd_update_current_slot(ubyte mfd_id, ubyte status, ubyte num_steps) {
     // If the change bit is set, or if the function is incremental
     // and enough time has gone by, then we need to expose
 
+    // Unless the func can say what it draws from, and none of that has
+    // changed since it last drew this mfd; then what's up is already right.
+    if (!full_game_3d && !(status & MFD_CHANGEBIT_FULL) && (num_steps == 0) && (f->state != NULL)) {
+        ulong hash = RETAIN_HASH_START;
+        hash = retain_hash_var(hash, f_id);
+        hash = retain_hash_var(hash, convert_use_mode);
+        if (!retain_check(&mfd_panels[mfd_id], f->state(m, hash))) {
+            if (f->flags & MFD_POLLS)
+                player_struct.mfd_func_status[f_id] |= MFD_CHANGEBIT;
+            return FALSE;
+        }
+    } else
+        retain_drew(&mfd_panels[mfd_id]);
+
     {
 #ifdef SVGA_SUPPORT
         uchar old_over = gr2ss_override;
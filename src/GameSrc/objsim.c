@@ -249,6 +249,15 @@ Id posture_bases[] = {
 
 #define CRITTER_LOADING_PAGE_LIMIT 45000
 
+// What ref_from_critter_data keeps around so it doesnt have to go to the
+//  resource system every draw.  The frame counts for the side views never
+//  change, so they are filled in the first time each one is asked for.  Once
+//  we know some view of a critter is in memory we note the resource
+//  generation, and as long as nothing has been dropped since, it still is.
+static uchar crit_view_frames[NUM_CRITTER][MOVING_CRITTER_POSTURE + 1][8]; // 0 until we have looked
+static uint crit_loaded_gen[NUM_CRITTER];
+static uchar crit_loaded_ok[NUM_CRITTER];
+
 Ref ref_from_critter_data(ObjID oid, int triple, byte posture, short frame, short view) //, uchar *pmirror)
 {
     Ref retval;
@@ -259,6 +268,8 @@ Ref ref_from_critter_data(ObjID oid, int triple, byte posture, short frame, shor
     RefTable *prt;
     char curr_frames;
     uchar load_all_views = TRUE;
+    uchar *cached_frames;
+    int c;
     //   extern ulong page_amount;
 
     // Set mirror pointer
@@ -271,10 +282,13 @@ Ref ref_from_critter_data(ObjID oid, int triple, byte posture, short frame, shor
         break;
     }
 
+    c = CPTRIP(triple);
     //   if (page_amount > CRITTER_LOADING_PAGE_LIMIT)
     //      load_all_views = FALSE;
     //   else
-    {
+    if (crit_loaded_ok[c] && (crit_loaded_gen[c] == resGeneration))
+        load_all_views = FALSE;
+    else {
         for (p = STANDING_CRITTER_POSTURE; p <= MOVING_CRITTER_POSTURE; p++) {
             for (v = 0; v < 8; v++) {
                 Id id;
@@ -291,14 +305,15 @@ Ref ref_from_critter_data(ObjID oid, int triple, byte posture, short frame, shor
         retval = MKREF(posture_bases[posture] + get_nth_from_triple(triple), frame);
     else {
         our_id = critter_id_table[get_nth_from_triple(triple)] + view + posture_bases[posture];
+        cached_frames = &crit_view_frames[c][posture][view];
         if (CritterProps[CPTRIP(triple)].frames[posture] == 0)
             posture = DEFAULT_CRITTER_POSTURE;
         if (view == FRONT_VIEW)
             curr_frames = CritterProps[CPTRIP(triple)].frames[posture];
-        else {
+        else if ((curr_frames = *cached_frames) == 0) {
             //         prt = ResReadRefTable(our_id);
             prt = (RefTable *)ResLock(our_id);
-            curr_frames = prt->numRefs;
+            curr_frames = *cached_frames = prt->numRefs;
             //         ResFreeRefTable(prt);
             ResUnlock(our_id);
         }
@@ -328,6 +343,9 @@ Ref ref_from_critter_data(ObjID oid, int triple, byte posture, short frame, shor
     // suspend game time for the duration of the loading
     last_real_time += *tmd_ticks - old_ticks;
 
+    crit_loaded_gen[c] = resGeneration;
+    crit_loaded_ok[c] = TRUE;
+
     return (retval);
 }
 
@@ -57,6 +57,13 @@ void finish_pal_effect(byte id) {
         inc = elapsed - inc_last;
         inc_last = elapsed;
 
+        // Nothing to show until a step has gone by, and the screen only
+        // gets the colors that changed.
+        if (inc == 0) {
+            SDL_Delay(1);
+            continue;
+        }
+
         while (inc > 0 && palette_query_effect(id) == ACTIVE) {
             palette_advance_effect(id, 1);
             inc--;
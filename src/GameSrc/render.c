@@ -49,6 +49,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "mapflags.h"
 #include "wares.h"
 #include "gr2ss.h"
+#include "autodet.h"
+#include "textmaps.h"
 
 frc *hack_cam_frcs[MAX_CAMERAS_VISIBLE];
 grs_canvas hack_cam_canvases[MAX_CAMERAS_VISIBLE], static_canvas;
@@ -324,7 +326,10 @@ errtype render_run(void) {
         rendrect = mainview_region->r;
 
         // printf("fr_rend\n");
+        textures_prefetch();
+        autodet_frame_start();
         fr_rend(NULL);
+        autodet_frame_end();
 
         if (view360_render_on)
             view360_render();
@@ -40,6 +40,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "init.h"
 
 #include "textmaps.h"
+#include "effect.h"
 #include "gettmaps.h"
 
 #include "frcamera.h"
@@ -302,6 +303,7 @@ grs_bitmap *game_fr_tmap_128(void) {
         }
     }
 
+    animtext_catch_up(textprops[_game_fr_tmap].anim_group);
     draw_me = get_texture_map(_game_fr_tmap + ANIMTEXT_FRAME(_game_fr_tmap), loop);
     return draw_me;
 }
@@ -317,6 +319,7 @@ grs_bitmap *game_fr_tmap_64(void) {
             loop++; // now 16
     }
 
+    animtext_catch_up(textprops[_game_fr_tmap].anim_group);
     draw_me = get_texture_map(_game_fr_tmap + ANIMTEXT_FRAME(_game_fr_tmap), loop);
     return draw_me;
 }
@@ -348,6 +351,7 @@ grs_bitmap *game_fr_tmap_full(void) {
 #endif
 
 draw_it:
+    animtext_catch_up(textprops[_game_fr_tmap].anim_group);
     draw_me = get_texture_map(_game_fr_tmap + ANIMTEXT_FRAME(_game_fr_tmap), loop);
     return draw_me;
 }
@@ -458,7 +462,10 @@ void game_redrop_rad(int rad_mod) {
 extern int _fr_global_detail;
 void change_detail_level(byte new_level) { _fr_global_detail = new_level; }
 
-void set_global_lighting(short l_lev) { _frp.lighting.global_mod += l_lev; }
+void set_global_lighting(short l_lev) {
+    _frp.lighting.global_mod += l_lev;
+    fr_light_changed();
+}
 
 void rendedit_process_tilemap(FullMap *fmap, LGRect *r, uchar newMap) {
     //   mprintf("RPT %d\n",new);
@@ -0,0 +1,99 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/*
+ * retain.c
+ *
+ * retained drawing for interface panels
+ *
+ * The MFDs and inventory get asked to redraw far more often than anything
+ *  on them changes: change flags get set every frame by ware effects,
+ *  flashing buttons and the like.  A panel here is whatever is left up from
+ *  its last drawing, plus a hash of the state that drawing was made from.
+ *  The owner hashes what it's about to draw from, and when that comes out
+ *  the same, what's up is already right and the drawing is skipped.
+ *  Anything that draws over a panel, or draws it from state it can't hash,
+ *  just says so, and a mode change or full screen redraw throws out every
+ *  panel at once.
+ */
+
+#include "retain.h"
+
+#define RETAIN_MAX 8 // panels we can keep track of
+
+static retained_panel *retain_panels[RETAIN_MAX];
+static int retain_panel_cnt = 0;
+
+// Internal Prototypes
+static uchar retain_register(retained_panel *p);
+
+// a panel that isn't on the list never gets vouched for, since
+// retain_invalidate_all() couldn't reach it
+static uchar retain_register(retained_panel *p) {
+    if (!p->registered && (retain_panel_cnt < RETAIN_MAX)) {
+        retain_panels[retain_panel_cnt++] = p;
+        p->registered = TRUE;
+    }
+    return p->registered;
+}
+
+// fnv-1a
+ulong retain_hash(ulong h, void *p, int len) {
+    uchar *s = (uchar *)p;
+    for (; len > 0; len--, s++)
+        h = (h ^ *s) * 16777619u;
+    return h;
+}
+
+uchar retain_check(retained_panel *p, ulong hash) {
+    uchar listed = retain_register(p);
+    if (p->valid && (p->hash == hash)) {
+        p->skips++;
+        return FALSE;
+    }
+    p->hash = hash;
+    p->valid = listed;
+    p->draws++;
+    return TRUE;
+}
+
+void retain_drew(retained_panel *p) {
+    retain_register(p);
+    p->valid = FALSE;
+    p->draws++;
+}
+
+void retain_invalidate_all(void) {
+    int i;
+
+    for (i = 0; i < retain_panel_cnt; i++)
+        retain_panels[i]->valid = FALSE;
+}
+
+void retain_report(void) {
+    retained_panel *p;
+    int i;
+
+    for (i = 0; i < retain_panel_cnt; i++) {
+        p = retain_panels[i];
+        if (p->draws + p->skips == 0)
+            continue;
+        INFO("retain: %s drew %lu of %lu times", p->name, p->draws, p->draws + p->skips);
+        p->draws = p->skips = 0;
+    }
+}
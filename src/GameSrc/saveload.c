@@ -425,6 +425,7 @@ errtype save_current_map(char *fname, Id id_num, uchar flush_mem, uchar pack) {
 
     //   idx++; // where flickers once lived
     idx++; // KLC - not used   REF_WRITE(id_num,idx++,filler);
+    animtext_catch_up_all();
     REF_WRITE(id_num, idx++, animtextures);
 
     REF_WRITE(id_num, idx++, hack_cam_objs);
@@ -1460,6 +1461,7 @@ errtype load_current_map(Id id_num, FSSpec *spec) {
     REF_READ(id_num, idx++, h_sems); // Unbelievably, no conversion needed.
 
 obj_out:
+    anim_lazy_reset();
     bounds.ul.x = bounds.ul.y = 0;
     bounds.lr.x = global_fullmap->x_size;
     bounds.lr.y = global_fullmap->y_size;
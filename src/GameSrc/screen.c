@@ -52,6 +52,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "invent.h"
 #include "invdims.h"
 #include "Shock.h"
+#include "retain.h"
 
 /*
 KLC - stereo
@@ -320,6 +321,7 @@ errtype screen_draw(void) {
     // very few times, and in general just the changing parts
     // get a signal to draw themselves.
     uiHideMouse(NULL);
+    retain_invalidate_all();
     _screen_background();
 
     screen_init_mfd_draw();
@@ -85,12 +85,25 @@ uchar std_alias_color_table[256];
 extern g3s_vector _matrix_scale;
 extern g3s_phandle _vbuf2;
 extern int _n_verts;
+extern g3s_matrix view_matrix;
+extern long _scrw, _scrh;
+extern fix _biasx, _biasy;
+
+// unpacked copies of the star vectors, and room for the stars that survive culling,
+// for the batched software path
+static fix *std_ux, *std_uy, *std_uz;
+static fix *std_bx, *std_by, *std_bz;
+static int *std_bi;
+static int std_soa_num = -1; // how many are unpacked, -1 when std_vec has changed
+static sts_vec *std_soa_vec;
 
 // prototypes
 fix mag2_point(g3s_phandle p);
 void do_aa_star_pixel(int x, int y, int fx, int fy, int c);
 void do_aa_star(fix fx, fix fy, int c);
 void star_init_alias_table(void);
+uchar star_soa_build(void);
+void star_render_batch(int anti_alias);
 
 // sets global pointers in the star library
 // to the number of stars, their positions, their colors
@@ -98,6 +111,7 @@ void star_set(int n, sts_vec *vlist, uchar *clist) {
     std_num = n;
     std_vec = vlist;
     std_col = clist;
+    std_soa_num = -1;
 }
 
 // allocates the necessary space for stars using alloc
@@ -107,12 +121,16 @@ int star_alloc(int n) {
         return -1;
     std_col = (uchar *)(std_vec + n);
     std_num = n;
+    std_soa_num = -1;
     return n;
 }
 
 // frees star space using free, only if you've used
 // alloc to allocate it
-void star_free(void) { free(std_vec); }
+void star_free(void) {
+    free(std_vec);
+    std_soa_num = -1;
+}
 
 // renders star field in the polygon defined by the vertex list
 // uses your 3d context, so make sure that's been set
@@ -249,6 +267,105 @@ void star_init_alias_table(void) {
 
 #endif
 
+// unpack the star vectors into x, y and z arrays, once per star set
+uchar star_soa_build(void) {
+    int i;
+    fix *f;
+
+    if ((std_soa_num == std_num) && (std_soa_vec == std_vec))
+        return TRUE;
+    free(std_ux);
+    std_ux = NULL;
+    std_soa_num = -1;
+    if ((std_num <= 0) || ((f = (fix *)malloc(std_num * (6 * sizeof(fix) + sizeof(int)))) == NULL))
+        return FALSE;
+    std_ux = f;
+    std_uy = f + std_num;
+    std_uz = f + 2 * std_num;
+    std_bx = f + 3 * std_num;
+    std_by = f + 4 * std_num;
+    std_bz = f + 5 * std_num;
+    std_bi = (int *)(f + 6 * std_num);
+    for (i = 0; i < std_num; i++) {
+        std_ux[i] = ((fix)std_vec[i].x) << 1;
+        std_uy[i] = ((fix)std_vec[i].y) << 1;
+        std_uz[i] = ((fix)std_vec[i].z) << 1;
+    }
+    std_soa_num = std_num;
+    std_soa_vec = std_vec;
+    return TRUE;
+}
+
+#define star_plot(p, c)   \
+    do {                  \
+        if (*(p) == 0xff) \
+            *(p) = (c);   \
+    } while (0)
+#define star_on_canvas(x, y) \
+    (((x) >= grd_clip.left) && ((x) < grd_clip.right) && ((y) >= grd_clip.top) && ((y) < grd_clip.bot))
+
+// Same stars as the loop in star_render, in three passes over all of them.
+//  Rotate everything and drop whatever is behind std_min_z or out of the view
+//  pyramid (what star_transform_point and code_point would do), project what
+//  is left, then write the pixels straight into the canvas wherever the sky
+//  polygon left its 0xff.
+void star_render_batch(int anti_alias) {
+    fix m1 = vm1, m2 = vm2, m3 = vm3, m4 = vm4, m5 = vm5, m6 = vm6, m7 = vm7, m8 = vm8, m9 = vm9;
+    fix x, y, z, min_z = (std_min_z > 1) ? std_min_z : 1;
+    int i, n = 0, sx, sy, x1, y1, row = grd_bm.row;
+    uchar *bits = grd_bm.bits, *p;
+
+    for (i = 0; i < std_num; i++) {
+        z = (fix)(((int64_t)std_ux[i] * m3 + (int64_t)std_uy[i] * m6 + (int64_t)std_uz[i] * m9) >> 16);
+        if (z < min_z)
+            continue;
+        x = (fix)(((int64_t)std_ux[i] * m1 + (int64_t)std_uy[i] * m4 + (int64_t)std_uz[i] * m7) >> 16);
+        y = (fix)(((int64_t)std_ux[i] * m2 + (int64_t)std_uy[i] * m5 + (int64_t)std_uz[i] * m8) >> 16);
+        if ((x > z) || (x < -z) || (y > z) || (y < -z))
+            continue;
+        std_bx[n] = x;
+        std_by[n] = y;
+        std_bz[n] = z;
+        std_bi[n++] = i;
+    }
+
+    // inside the pyramid |x|,|y| <= z, so these cant overflow
+    for (i = 0; i < n; i++) {
+        std_bx[i] = (fix)(((int64_t)std_bx[i] * _scrw) / std_bz[i]) + _biasx;
+        std_by[i] = _biasy - (fix)(((int64_t)std_by[i] * _scrh) / std_bz[i]);
+    }
+
+    for (i = 0; i < n; i++) {
+        uchar c = std_col[std_bi[i]];
+        sx = fix_rint(std_bx[i]);
+        sy = fix_rint(std_by[i]);
+        if (std_size > 1) {
+            for (y1 = sy; y1 < sy + std_size; ++y1)
+                for (x1 = sx; x1 < sx + std_size; ++x1)
+                    if (star_on_canvas(x1, y1))
+                        star_plot(bits + y1 * row + x1, c);
+        }
+#ifdef STARS_ANTI_ALIAS
+        else if (anti_alias) {
+            // the weights and colors of do_aa_star
+            int fx = fix_frac(std_bx[i]) >> 8, fy = fix_frac(std_by[i]) >> 8;
+            int col = (255 * (std_color_base + std_color_range - 1 - c)) / (std_color_range + 1);
+            int wx[2] = {256 - fx, fx}, wy[2] = {256 - fy, fy};
+            int dx, dy;
+            sx = fix_int(std_bx[i]);
+            sy = fix_int(std_by[i]);
+            for (dy = 0; dy < 2; dy++)
+                for (dx = 0; dx < 2; dx++)
+                    if (star_on_canvas(sx + dx, sy + dy))
+                        star_plot(bits + (sy + dy) * row + sx + dx,
+                                  std_alias_color_table[(wx[dx] * wy[dy] * col) >> 16]);
+        }
+#endif
+        else if (star_on_canvas(sx, sy))
+            star_plot(bits + sy * row + sx, c);
+    }
+}
+
 void star_render(void) {
     int i;
     g3s_phandle s;
@@ -303,7 +420,22 @@ void star_render(void) {
     g3d_stereo = 0;
 #endif
 
-    for (i = 0; i < std_num; ++i) {
+    // straight to the canvas when nothing fancy is going on
+    if (!use_opengl() && (grd_bm.type == BMT_FLAT8) && (grd_gc.fill_type == FILL_NORM)
+#ifdef STEREO_ON
+        && !old_stereo
+#endif
+        && star_soa_build()) {
+#ifdef STARS_ANTI_ALIAS
+        star_render_batch(anti_alias);
+#else
+        star_render_batch(FALSE);
+#endif
+        i = std_num; // skip the point at a time loop
+    } else
+        i = 0;
+
+    for (; i < std_num; ++i) {
         // in theory if codes aren't set it's on the screen
 
         // unpack star vec to a normal vec
@@ -426,10 +558,10 @@ void star_rand(uchar col, uchar range) {
         // assign color
         std_col[i] = rand() % range + col;
     }
+    std_soa_num = -1;
 }
 
 extern g3s_point *first_free;
-extern g3s_matrix view_matrix;
 extern int code_point(g3s_point *pt);
 
 // matrix rotate and code a star point.  Project if clip codes
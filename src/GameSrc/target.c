@@ -55,6 +55,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "mfdart.h"
 #include "cit2d.h"
 #include "gr2ss.h"
+#include "retain.h"
 
 #define sqr(x) ((x) * (x))
 
@@ -345,6 +346,51 @@ void mfd_target_expose(MFD *m, ubyte control) {
     return;
 }
 
+// ----------------------------------------------------------------------------
+// mfd_target_init()
+//
+// The target mfd re-notifies itself every time it draws, to keep the range
+// current, so it says what it draws from and only draws when some of it moved.
+// MFD_POLLS keeps it being asked while its draws are skipped.
+
+errtype mfd_target_init(MFD_Func *f) {
+    f->state = mfd_target_state;
+    f->flags |= MFD_POLLS;
+    return OK;
+}
+
+// ----------------------------------------------------------------------------
+// mfd_target_state()
+//
+// Everything mfd_target_expose() looks at.
+
+ulong mfd_target_state(MFD *m, ulong hash) {
+    ObjID id = player_struct.curr_target;
+    ObjSpecID target = objs[id].specID;
+
+    hash = retain_hash_var(hash, player_struct.hardwarez[CPTRIP(TARG_GOG_TRIPLE)]);
+    hash = retain_hash_var(hash, id);
+    hash = retain_hash_var(hash, player_struct.level);
+    hash = retain_hash_var(hash, player_struct.num_victories);
+    hash = retain_hash(hash, player_struct.mfd_func_data[MFD_TARGET_FUNC], sizeof(player_struct.mfd_func_data[0]));
+    if ((player_struct.hardwarez[CPTRIP(TARG_GOG_TRIPLE)] < 1) || (target == OBJ_SPEC_NULL))
+        return hash;
+
+    hash = retain_hash_var(hash, objs[id].subclass);
+    hash = retain_hash_var(hash, objs[id].info.type);
+    hash = retain_hash_var(hash, objs[id].info.current_hp);
+    hash = retain_hash_var(hash, objs[id].loc.x);
+    hash = retain_hash_var(hash, objs[id].loc.y);
+    hash = retain_hash_var(hash, objs[id].loc.z);
+    hash = retain_hash_var(hash, objs[PLAYER_OBJ].loc.x);
+    hash = retain_hash_var(hash, objs[PLAYER_OBJ].loc.y);
+    hash = retain_hash_var(hash, objs[PLAYER_OBJ].loc.z);
+    hash = retain_hash_var(hash, objCritters[target].mood);
+    hash = retain_hash_var(hash, objCritters[target].orders);
+    hash = retain_hash_var(hash, objCritters[target].flags);
+    return hash;
+}
+
     // ==============================================
     //               TARGET HARDWARE CODE
     // ==============================================
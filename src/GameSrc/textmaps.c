@@ -41,6 +41,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "objstuff.h"
 #include "tpolys.h"
 #include "statics.h"
+#include "map.h"
+#include "mapflags.h"
+#include "tilename.h"
+#include "player.h"
+#include "effect.h"
 
 #include "OpenGL.h"
 
@@ -59,7 +64,7 @@ Id tmap_ids[NUM_TEXTURE_SIZES] = {TEXTURE_128_ID, TEXTURE_64_ID, TEXTURE_32_ID,
 ushort tmap_sizes[NUM_TEXTURE_SIZES] = {128, 64, 32, 16};
 uchar all_textures = TRUE;
 
-extern uchar tmap_big_buffer[];
+extern uchar *tmap_big_buffer;
 
 // prototypes
 uchar set_animations(short start, short frames, uchar *anim_used);
@@ -160,37 +165,211 @@ static uchar *tmap_dynamic_mem = NULL;
 // have we built the tables, do we have the extra memory, so on
 static uchar tmaps_setup = FALSE;
 
+// Textures are no longer all read in at level load, each size of each texture
+//  is read the first time get_texture_map is asked for it.  The 64, 32 and 16
+//  sizes keep their own spot in tmap_static_mem.  The 128s share a pool of
+//  tmap_big_budget spots in the big buffer, which is only made that big, and
+//  when the pool is full the one used least recently, and not this frame, is
+//  thrown out.  If every 128 in the pool is on screen, we draw the 64 instead.
+int tmap_big_budget = TMAP_BIG_DEFAULT; // how many 128s we keep around, 16k each, from prefs
+static int tmap_big_cnt = 0;            // and how many the big buffer got made for
+
+static short tmap_res[NUM_LOADED_TEXTURES];    // which texture.res entry each slot really uses
+static uchar tmap_loaded[NUM_LOADED_TEXTURES]; // bit per size, set once its bits are in
+static char tmap_big_spot[NUM_LOADED_TEXTURES]; // where in the big buffer our 128 lives, or -1
+static char tmap_big_owner[NUM_STATIC_TMAPS];   // and who lives in each spot, or -1
+static ulong tmap_big_used[NUM_STATIC_TMAPS];
+static ulong tmap_frame = 1;
+static uchar tmap_lent = FALSE; // someone else is using our memory, hands off till load_textures
+
+// prefetch around the player, a few loads a frame so we dont hitch
+#define TMAP_PREFETCH_RAD 3
+#define TMAP_PREFETCH_MAX 4
+static short tmap_pf_x = -1, tmap_pf_y = -1;
+static uchar tmap_pf_done = FALSE;
+
+static int tmap_loads = 0, tmap_evicts = 0, tmap_big_misses = 0;
+
 static grs_bitmap tmap_bitmaps[NUM_TEXTURE_SIZES];
+
+// Internal Prototypes
+static void tmap_load_size(int c, int n, uchar *bits);
+static uchar *tmap_get_big(int c, uchar evict);
+static int tmap_prefetch_tile(MapElem *mptr, int budget);
+
 void setup_tmap_bitmaps(void) {
     int i;
     for (i = 0; i < 4; i++)
         gr_init_bm(&tmap_bitmaps[i], NULL, BMT_FLAT8, 0, tmap_sizes[i], tmap_sizes[i]);
 }
 
+static void tmap_load_size(int c, int n, uchar *bits) {
+    grs_bitmap *cur_bm = &tmap_bitmaps[n];
+    int i = tmap_res[c];
+
+    tmap_loaded[c] |= (1 << n); // even if it fails, so we dont try again every draw
+    cur_bm->bits = bits;
+#ifdef DEMO
+    if (n >= TEXTURE_32_INDEX)
+        return;
+#endif
+    // This is a BLATANT hack to get around the 1 Meg limit in the resource system
+    if ((n == TEXTURE_128_INDEX) || (n == TEXTURE_64_INDEX)) {
+        if (ResInUse(tmap_ids[n] + i)) {
+            load_res_bitmap(cur_bm, MKREF(tmap_ids[n] + i, 0), FALSE);
+            cur_bm->flags = 0;
+        } else {
+            // Warning(("Hey, ResInUse failed in tmap_load and i'm so blue
+            // (%d,%d,%x)\n",n,i,tmap_ids[n]+i));
+            // should abort !!!
+        }
+    } else {
+        load_res_bitmap(cur_bm, MKREF(tmap_ids[n], i), FALSE);
+        cur_bm->flags = 0;
+    }
+    if ((cur_bm->w != tmap_sizes[n]) || (cur_bm->h != tmap_sizes[n])) {
+        // Warning(("Incorrect size in tmap %d! (%d)(%d x %d) vs (%d x %d)\n",i,c,cur_bm->w,
+        //   cur_bm->h, tmap_sizes[n], tmap_sizes[n]));
+        // should abort !!!
+    }
+    if (can_use_opengl())
+        opengl_cache_wall_texture(c, n, cur_bm);
+    tmap_loads++;
+}
+
+// find, or make, a home for the 128 of slot c, NULL if there is no room this frame
+static uchar *tmap_get_big(int c, uchar evict) {
+    int j, spot;
+
+    if ((spot = tmap_big_spot[c]) < 0) {
+        for (j = 0; j < tmap_big_cnt; j++) {
+            if (tmap_big_owner[j] < 0) {
+                spot = j;
+                break;
+            }
+            if (evict && (tmap_big_used[j] != tmap_frame) && ((spot < 0) || (tmap_big_used[j] < tmap_big_used[spot])))
+                spot = j;
+        }
+        if (spot < 0) {
+            if (evict)
+                tmap_big_misses++;
+            return NULL;
+        }
+        if (tmap_big_owner[spot] >= 0) {
+            if (!evict)
+                return NULL;
+            tmap_big_spot[tmap_big_owner[spot]] = -1;
+            tmap_loaded[tmap_big_owner[spot]] &= ~(1 << TEXTURE_128_INDEX);
+            tmap_evicts++;
+        }
+        tmap_big_owner[spot] = c;
+        tmap_big_spot[c] = spot;
+    }
+    tmap_big_used[spot] = tmap_frame;
+    if ((tmap_loaded[c] & (1 << TEXTURE_128_INDEX)) == 0)
+        tmap_load_size(c, TEXTURE_128_INDEX, get_tmap_128x128(spot));
+    return get_tmap_128x128(spot);
+}
+
 grs_bitmap *get_texture_map(int idx, int sz) {
     ushort sz_add[NUM_TEXTURE_SIZES - 1] = {0, 64 * 64, (64 * 64) + (32 * 32)};
-    uchar *bt;
+    uchar *bt = NULL;
+    uchar can_load = textures_loaded && !tmap_lent && (idx >= 0) && (idx < NUM_LOADED_TEXTURES);
 //   mprintf("Getting tmap %d, sz %d\n",idx,sz);
 #ifdef DEMO
     if (sz == 2)
         sz = 1;
 #endif
-    if (sz == 0)
-        if (all_textures)
-            bt = get_tmap_128x128(idx);
-        else
+    if (sz == 0) {
+        if (!all_textures)
             sz = 1;
+        else if (!can_load) {
+            // only if it is already in, wherever in the pool that is
+            if ((idx >= 0) && (idx < NUM_LOADED_TEXTURES) && (tmap_big_spot[idx] >= 0) &&
+                (tmap_loaded[idx] & (1 << TEXTURE_128_INDEX)))
+                bt = get_tmap_128x128(tmap_big_spot[idx]);
+            else
+                sz = 1;
+        } else if ((bt = tmap_get_big(idx, TRUE)) == NULL)
+            sz = 1;
+    }
     if (sz != 0) {
         bt = get_tmap_64x64(idx) + sz_add[sz - 1];
+        if (can_load && ((tmap_loaded[idx] & (1 << sz)) == 0))
+            tmap_load_size(idx, sz, bt);
     }
     tmap_bitmaps[sz].bits = bt;
     return &tmap_bitmaps[sz];
 }
 
+// the static texture memory is about to be used for something else, vmail,
+//  shodan taking over the screen, stop loading into it until load_textures
+void textures_lend_buffers(void) { tmap_lent = TRUE; }
+
+static int tmap_prefetch_tile(MapElem *mptr, int budget) {
+    int t, c, n;
+    for (t = 0; t < 3; t++) {
+        c = (t == 0) ? me_tmap_flr(mptr) : ((t == 1) ? me_tmap_ceil(mptr) : me_tmap_wall(mptr));
+        if (c >= NUM_LOADED_TEXTURES)
+            continue;
+        c += ANIMTEXT_FRAME(c);
+        for (n = TEXTURE_64_INDEX; n < NUM_TEXTURE_SIZES; n++)
+            if ((tmap_loaded[c] & (1 << n)) == 0) {
+                get_texture_map(c, n);
+                budget--;
+            }
+        // only into free room, prefetching never throws out a texture
+        if (all_textures && ((tmap_loaded[c] & (1 << TEXTURE_128_INDEX)) == 0) && (tmap_get_big(c, FALSE) != NULL))
+            budget--;
+        if (budget <= 0)
+            break;
+    }
+    return budget;
+}
+
+// once a frame, before the 3d view draws
+void textures_prefetch(void) {
+    int x, y, budget = TMAP_PREFETCH_MAX;
+
+    tmap_frame++;
+    if (animtext_changed) {
+        animtext_changed = 0;
+        tmap_pf_done = FALSE; // new frames showing, make sure they are in
+    }
+    if (!textures_loaded || tmap_lent || global_fullmap->cyber)
+        return;
+    if ((tmap_pf_x != PLAYER_BIN_X) || (tmap_pf_y != PLAYER_BIN_Y)) {
+        tmap_pf_x = PLAYER_BIN_X;
+        tmap_pf_y = PLAYER_BIN_Y;
+        tmap_pf_done = FALSE;
+    }
+    if (tmap_pf_done)
+        return;
+    for (y = tmap_pf_y - TMAP_PREFETCH_RAD; y <= tmap_pf_y + TMAP_PREFETCH_RAD; y++)
+        for (x = tmap_pf_x - TMAP_PREFETCH_RAD; x <= tmap_pf_x + TMAP_PREFETCH_RAD; x++) {
+            if ((x < 0) || (x >= MAP_XSIZE) || (y < 0) || (y >= MAP_YSIZE))
+                continue;
+            if (me_tiletype(MAP_GET_XY(x, y)) == TILE_SOLID)
+                continue;
+            if ((budget = tmap_prefetch_tile(MAP_GET_XY(x, y), budget)) <= 0)
+                return; // pick up here next frame
+        }
+    tmap_pf_done = TRUE;
+}
+
+void textures_stats(void) {
+    int c, n, cnt[NUM_TEXTURE_SIZES] = {0, 0, 0, 0};
+    for (c = 0; c < NUM_LOADED_TEXTURES; c++)
+        for (n = 0; n < NUM_TEXTURE_SIZES; n++)
+            if (tmap_loaded[c] & (1 << n))
+                cnt[n]++;
+    DEBUG("%s: %d/%d/%d/%d resident, %d loads %d evicts %d 128 misses", __FUNCTION__, cnt[0], cnt[1], cnt[2], cnt[3],
+          tmap_loads, tmap_evicts, tmap_big_misses);
+    tmap_loads = tmap_evicts = tmap_big_misses = 0;
+}
+
 void load_textures(void) {
-    grs_bitmap *cur_bm;
-    int i, n, c;
-    errtype retval = OK;
+    int i, c;
     int atext_tmp = 1;
 
     {
@@ -207,6 +386,17 @@ void load_textures(void) {
     // Spew(DSRC_GFX_Texturemaps, ("GAME_TEXTURES = %d\n",GAME_TEXTURES));
 
     if (!tmaps_setup) {
+        // the big buffer gets borrowed by the endgame shodan overlay too, so it is
+        //  there even without 128s, and never smaller than that needs
+        if (tmap_big_buffer == NULL) {
+            tmap_big_cnt = all_textures ? tmap_big_budget : 0;
+            if (tmap_big_cnt > NUM_STATIC_TMAPS)
+                tmap_big_cnt = NUM_STATIC_TMAPS;
+            if ((tmap_big_buffer = (uchar *)malloc(
+                     ((tmap_big_cnt > TMAP_BIG_MIN) ? tmap_big_cnt : TMAP_BIG_MIN) * SIZE_BIG_TMAP)) == NULL)
+                critical_error(CRITERR_MEM | 7);
+            DEBUG("%s: room for %d 128s", __FUNCTION__, tmap_big_cnt);
+        }
         if (all_textures) // get our butts some memory
             tmap_dynamic_mem = tmap_big_buffer;
 
@@ -214,50 +404,23 @@ void load_textures(void) {
         tmaps_setup = TRUE;
     }
 
+    // forget whatever we had, it all comes back in as it gets drawn
     for (c = 0; c < NUM_LOADED_TEXTURES; c++) {
         i = loved_textures[c];
         if (!ResInUse(TEXTURE_64_ID + i)) {
             // Warning(("Hey, invalid texture in palette! slot %d = %d\n",c,i));
             i = 0;
         } // Set local properties
-        for (n = SMALLEST_SIZE_INDEX; n < NUM_TEXTURE_SIZES; n++) {
-            if ((n != TEXTURE_128_INDEX) || all_textures) {
-#ifdef DEMO
-                if (n == TEXTURE_32_INDEX)
-                    break;
-#endif
-                cur_bm = get_texture_map(c, n);
-
-                // This is a BLATANT hack to get around the 1 Meg limit in the resource system
-                if ((n == TEXTURE_128_INDEX) || (n == TEXTURE_64_INDEX)) {
-                    if (ResInUse(tmap_ids[n] + i)) {
-                        retval = load_res_bitmap(cur_bm, MKREF(tmap_ids[n] + i, 0), FALSE);
-                        cur_bm->flags = 0;
-                    } else {
-                        // Warning(("Hey, ResInUse failed in tmap_load and i'm so blue
-                        // (%d,%d,%x)\n",n,i,tmap_ids[n]+i));
-                        // should abort !!!
-                    }
-                } else {
-                    retval = load_res_bitmap(cur_bm, MKREF(tmap_ids[n], i), FALSE);
-                    cur_bm->flags = 0;
-                }
-                if ((cur_bm->w != tmap_sizes[n]) || (cur_bm->h != tmap_sizes[n])) {
-                    // Warning(("Incorrect size in tmap %d! (%d)(%d x %d) vs (%d x %d)\n",i,c,cur_bm->w,
-                    //   cur_bm->h, tmap_sizes[n], tmap_sizes[n]));
-                    // should abort !!!
-                    //               DBG(DSRC_GFX_Texturemaps, {
-                    //                              gr_set_fcolor(0);
-                    //                              gr_rect(0,0,320,200);
-                    //                              gr_bitmap(cur_bm, 0, 0);
-                    //               });
-                }
-                if(can_use_opengl())
-                    opengl_cache_wall_texture(c, n, cur_bm);
-            }
-            AdvanceProgress();
-        }
+        tmap_res[c] = i;
+        tmap_loaded[c] = 0;
+        tmap_big_spot[c] = -1;
     }
+    for (c = 0; c < NUM_STATIC_TMAPS; c++)
+        tmap_big_owner[c] = -1;
+    tmap_lent = FALSE;
+    tmap_pf_x = tmap_pf_y = -1;
+    AdvanceProgress();
+
     // Load in texture properties for all textures
     load_master_texture_properties();
     AdvanceProgress();
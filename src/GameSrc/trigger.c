@@ -939,6 +939,7 @@ errtype trap_lighting_func(uchar floor, int p1, int p2, int p3, int p4) {
         }
     }
 
+    fr_light_changed();
     return (OK);
 }
 
@@ -1408,6 +1409,7 @@ void hack_shodan_conquer_func(char c) {
     extern ulong time_until_shodan_avatar;
     extern char thresh_fail;
     extern uchar shodan_phase_in(uchar * bitmask, short x, short y, short w, short h, short num, uchar dir);
+    textures_lend_buffers();
     shodan_bitmask = tmap_static_mem;
     LG_memset(shodan_bitmask, 0, SHODAN_BITMASK_SIZE / 8);
     shodan_draw_fs.bits = tmap_static_mem + (SHODAN_BITMASK_SIZE / 8);
@@ -72,6 +72,14 @@ uchar view360_render_on = FALSE;
 short view360_last_update = 0;
 uchar view360_is_rendering = FALSE;
 
+// with more than one view up and view360_stagger set, only one gets rendered a frame, in
+// turn, and the others keep showing what they had, like the hack cameras, so with all
+// three up each gets a third of the frame rate.  a view which just came up always renders.
+uchar view360_stagger = TRUE;
+static uchar view360_turn = 0;
+static uchar view360_fresh[NUM_360_CONTEXTS]; // has this context got a picture since it came up
+static uchar view360_fresh_full;              // were the fresh bits for the fullscreen contexts
+
 // ---------
 // INTERNALS
 // ---------
@@ -139,10 +147,10 @@ extern grs_canvas _offscreen_mfd, _fullscreen_mfd, inv_view360_canvas;
 
 static uchar rendered_inv_fullscrn = FALSE;
 
-extern void shock_hflip_in_place(grs_bitmap *bm);
+extern void shock_hflip_bitmap(grs_bitmap *bm, short x, short y);
 
 int view360_fullscrn_draw_callback(void *v, void *vbm, int x, int y, int flg) {
-    // KLC   shock_hflip_in_place((grs_bitmap *)vbm);
+    // KLC   shock_hflip_bitmap((grs_bitmap *)vbm, x, y);
     return FALSE;
 }
 
@@ -220,6 +228,7 @@ void view360_shutdown(void) {
 void view360_update_screen_mode() {
     view360_shutdown();
     view360_init();
+    LG_memset(view360_fresh, FALSE, sizeof(view360_fresh));
 }
 
 char update_string[30] = "";
@@ -227,7 +236,7 @@ char update_string[30] = "";
 void view360_render(void) {
     opengl_begin_sensaround(player_struct.hardwarez[CPTRIP(SENS_HARD_TRIPLE)]);
     uchar on = FALSE;
-    int i;
+    int i, cnt;
     if (inventory_page != INV_3DVIEW_PAGE && ACTIVE[MID_CONTEXT]) {
         view360_restore_inventory();
     }
@@ -283,10 +292,23 @@ void view360_render(void) {
     }
 
     // Render the 360 view scenes.
+    if (view360_fresh_full != full_game_3d) {
+        LG_memset(view360_fresh, FALSE, sizeof(view360_fresh));
+        view360_fresh_full = full_game_3d;
+    }
+    for (i = 0, cnt = 0; i < NUM_360_CONTEXTS; i++)
+        if (ACTIVE[i])
+            cnt++;
+        else
+            view360_fresh[i] = FALSE;
+    view360_turn = (cnt > 1) ? (view360_turn + 1) % cnt : 0;
     view360_is_rendering = TRUE;
-    for (i = 0; i < NUM_360_CONTEXTS; i++)
+    for (i = 0, cnt = 0; i < NUM_360_CONTEXTS; i++)
         if (ACTIVE[i]) {
-            fr_rend(CONTEXT[i]);
+            if (!view360_stagger || (cnt++ == view360_turn) || !view360_fresh[i] || use_opengl()) {
+                fr_rend(CONTEXT[i]);
+                view360_fresh[i] = TRUE;
+            }
             if (full_game_3d) {
 #ifdef STEREO_SUPPORT
                 if (convert_use_mode == 5)
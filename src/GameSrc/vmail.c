@@ -170,6 +170,7 @@ errtype play_vmail_intro(uchar use_texture_buffer)
 
    if (use_texture_buffer)
    {
+      textures_lend_buffers();
       AnimSetDataBufferSafe(main_anim, tmap_static_mem,sizeof(tmap_static_mem));
       AnimPreloadFrames(main_anim, REF_ANIM_vintro);
    }
@@ -372,6 +373,7 @@ errtype play_vmail(byte vmail_no)
       }
       if(use_texture_buffer)
       {
+         textures_lend_buffers();
          AnimSetDataBufferSafe(main_anim, tmap_static_mem, sizeof(tmap_static_mem));
          AnimPreloadFrames(main_anim, vmail_ref);
       }
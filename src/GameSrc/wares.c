@@ -37,6 +37,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "textmaps.h"
 #include "render.h"
 #include "frparams.h"
+#include "frprotox.h"
 #include "FrUtils.h"
 #include "objsim.h"
 #include "otrip.h"
@@ -575,6 +576,7 @@ void lamp_set_vals_with_offset(byte offset) {
         _frp.lighting.rad[1] = (uchar)lspec->rad2;
     _frp.lighting.base[1] = (uchar)lspec->base2;
 
+    fr_light_changed();
     chg_set_flg(_current_3d_flag);
     //   Warning(("New parms %x %x, %x %x, line %x %x from %x %x\n",
     //      _frp.lighting.rad[0], _frp.lighting.base[0],
@@ -598,6 +600,7 @@ void lamp_change_setting(byte offset) {
 void lamp_turnoff(uchar visible, uchar real_stop) {
     if (visible) {
         _frp_light_bits_clear(LIGHT_BITS_CAM);
+        fr_light_changed();
         chg_set_flg(_current_3d_flag);
         if (real_stop)
             mfd_notify_func(MFD_LANTERN_FUNC, MFD_ITEM_SLOT, FALSE, MFD_ACTIVE, FALSE);
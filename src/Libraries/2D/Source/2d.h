@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "fix.h" 
 #ifndef __2D_H 
 #define __2D_H
+#include "dirty.h"   // what changed on the screen since it was last shown
 
 #pragma pack(2)
 
@@ -1747,8 +1748,20 @@ extern int tluc8nstab;
 extern uchar *grd_unpack_buf;
 extern int gr_rsd8_convert(grs_bitmap *sbm, grs_bitmap *dbm);
 #endif
+#include "rsdcache.h"
 uchar *gr_rsd8_unpack(uchar* src, uchar *dst);
 
+// sprite scaler, fl8spr.c
+extern int gr_sprite_runs_size(grs_bitmap *bm);
+extern void gr_sprite_runs_make(grs_bitmap *bm, uint *runs);
+extern int gr_scale_sprite(grs_bitmap *bm, uint *runs, fix x0, fix y0, fix x1, fix y1, uchar *clut);
+
+// palette expansion to 32 bit for the screen, fl8argb.c
+extern void gr_flat8_to_argb(uint32_t *dst, int pitch, uchar *src, int row, int w, int h, uint32_t *pal);
+extern void gr_flat8_to_argb_scale(uint32_t *dst, int pitch, uchar *src, int row, int w, int h, uint32_t *pal, int k);
+extern void gr_flat8_to_argb_scale2x(uint32_t *dst, int pitch, uchar *bits, int row, int bw, int bh, int x, int y, int w,
+                                     int h, uint32_t *pal);
+
 // MLA - added these from TMapFcn, so the 3d lib can get to them without including it
 
 
@@ -0,0 +1,206 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/*
+ * fl8argb.c
+ *
+ * Flat 8 to 32 bit ARGB through a palette, for handing the screen to SDL.
+ *
+ * A palette lookup is a gather, which SSE2 can't do, so four indices are
+ * read in one load and looked up one at a time, and the four results go out
+ * in one 16 byte store.  With AVX2 the lookup is a gather of eight.  The
+ * destination is usually a locked streaming texture, which may be write
+ * combined memory, so it is only ever written, never read.
+ *
+ * There are also two ways of scaling up on the way out, for when the
+ * renderer would otherwise stretch a small texture to the window itself:
+ * plain integer scaling, and Scale2x, which looks at each pixel's four
+ * neighbours to round off the stair steps in diagonal edges.  Scale2x only
+ * ever compares colors for equality, so it works on the 8 bit indices,
+ * sixteen at a time with SSE2, and what it makes is expanded afterward.
+ *
+ * This file is part of the 2d library.
+ *
+ */
+
+#include <string.h>
+#include "fix.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// one row of n pixels
+static void flat8_argb_row(uint32_t *d, uchar *s, int n, uint32_t *pal) {
+    int i = 0;
+    uint32_t v;
+
+#if defined(__AVX2__)
+    for (; i + 8 <= n; i += 8) {
+        __m256i k = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i *)(s + i)));
+        _mm256_storeu_si256((__m256i *)(d + i), _mm256_i32gather_epi32((const int *)pal, k, 4));
+    }
+#elif defined(__SSE2__)
+    for (; i + 4 <= n; i += 4) {
+        memcpy(&v, s + i, 4);
+        _mm_storeu_si128((__m128i *)(d + i),
+                         _mm_setr_epi32(pal[v & 0xff], pal[(v >> 8) & 0xff], pal[(v >> 16) & 0xff], pal[v >> 24]));
+    }
+#else
+    for (; i + 4 <= n; i += 4) {
+        memcpy(&v, s + i, 4);
+        d[i] = pal[v & 0xff];
+        d[i + 1] = pal[(v >> 8) & 0xff];
+        d[i + 2] = pal[(v >> 16) & 0xff];
+        d[i + 3] = pal[v >> 24];
+    }
+#endif
+    for (; i < n; i++)
+        d[i] = pal[s[i]];
+}
+
+// w x h pixels from src (row bytes apart) to dst (pitch bytes apart), each
+// becoming pal[pixel]
+void gr_flat8_to_argb(uint32_t *dst, int pitch, uchar *src, int row, int w, int h, uint32_t *pal) {
+    for (; h > 0; h--) {
+        flat8_argb_row(dst, src, w, pal);
+        dst = (uint32_t *)((uchar *)dst + pitch);
+        src += row;
+    }
+}
+
+#define SCALE_CHUNK 256 // source pixels done at a time, so the temporaries stay small
+
+// w x h pixels from src to dst as k x k blocks, dst is for w*k x h*k
+void gr_flat8_to_argb_scale(uint32_t *dst, int pitch, uchar *src, int row, int w, int h, uint32_t *pal, int k) {
+    uint32_t t[SCALE_CHUNK], *d;
+    int x, n, i, j, r;
+
+    if (k <= 1) {
+        gr_flat8_to_argb(dst, pitch, src, row, w, h, pal);
+        return;
+    }
+    for (; h > 0; h--, src += row) {
+        for (x = 0; x < w; x += n) {
+            n = (w - x < SCALE_CHUNK) ? w - x : SCALE_CHUNK;
+            flat8_argb_row(t, src + x, n, pal);
+            // each row gets built from t again, rather than read back out of dst
+            for (r = 0; r < k; r++) {
+                d = (uint32_t *)((uchar *)dst + r * pitch) + x * k;
+                i = 0;
+#if defined(__SSE2__)
+                if (k == 2)
+                    for (; i + 4 <= n; i += 4, d += 8) {
+                        __m128i v = _mm_loadu_si128((__m128i *)(t + i));
+                        _mm_storeu_si128((__m128i *)d, _mm_unpacklo_epi32(v, v));
+                        _mm_storeu_si128((__m128i *)(d + 4), _mm_unpackhi_epi32(v, v));
+                    }
+                else if (k == 4)
+                    for (; i + 4 <= n; i += 4, d += 16) {
+                        __m128i v = _mm_loadu_si128((__m128i *)(t + i));
+                        _mm_storeu_si128((__m128i *)d, _mm_shuffle_epi32(v, 0x00));
+                        _mm_storeu_si128((__m128i *)(d + 4), _mm_shuffle_epi32(v, 0x55));
+                        _mm_storeu_si128((__m128i *)(d + 8), _mm_shuffle_epi32(v, 0xaa));
+                        _mm_storeu_si128((__m128i *)(d + 12), _mm_shuffle_epi32(v, 0xff));
+                    }
+#endif
+                for (; i < n; i++)
+                    for (j = 0; j < k; j++)
+                        *d++ = t[i];
+            }
+        }
+        dst = (uint32_t *)((uchar *)dst + k * pitch);
+    }
+}
+
+// Scale2x on n indices, with b, e and h the rows above, at and below, each
+// with one pixel of the row's neighbours at both ends; top and bottom get
+// the 2n indices of the two rows it makes
+static void scale2x_row(uchar *b, uchar *e, uchar *h, int n, uchar *top, uchar *bot) {
+    int i = 0;
+    uchar B, D, E, F, H;
+
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16) {
+        __m128i vb = _mm_loadu_si128((__m128i *)(b + i + 1));
+        __m128i vd = _mm_loadu_si128((__m128i *)(e + i));
+        __m128i ve = _mm_loadu_si128((__m128i *)(e + i + 1));
+        __m128i vf = _mm_loadu_si128((__m128i *)(e + i + 2));
+        __m128i vh = _mm_loadu_si128((__m128i *)(h + i + 1));
+        __m128i db = _mm_cmpeq_epi8(vd, vb), bf = _mm_cmpeq_epi8(vb, vf);
+        __m128i dh = _mm_cmpeq_epi8(vd, vh), hf = _mm_cmpeq_epi8(vh, vf);
+        __m128i m0 = _mm_andnot_si128(_mm_or_si128(bf, dh), db);
+        __m128i m1 = _mm_andnot_si128(_mm_or_si128(db, hf), bf);
+        __m128i m2 = _mm_andnot_si128(_mm_or_si128(db, hf), dh);
+        __m128i m3 = _mm_andnot_si128(_mm_or_si128(dh, bf), hf);
+        __m128i e0 = _mm_or_si128(_mm_and_si128(m0, vd), _mm_andnot_si128(m0, ve));
+        __m128i e1 = _mm_or_si128(_mm_and_si128(m1, vf), _mm_andnot_si128(m1, ve));
+        __m128i e2 = _mm_or_si128(_mm_and_si128(m2, vd), _mm_andnot_si128(m2, ve));
+        __m128i e3 = _mm_or_si128(_mm_and_si128(m3, vf), _mm_andnot_si128(m3, ve));
+        _mm_storeu_si128((__m128i *)(top + 2 * i), _mm_unpacklo_epi8(e0, e1));
+        _mm_storeu_si128((__m128i *)(top + 2 * i + 16), _mm_unpackhi_epi8(e0, e1));
+        _mm_storeu_si128((__m128i *)(bot + 2 * i), _mm_unpacklo_epi8(e2, e3));
+        _mm_storeu_si128((__m128i *)(bot + 2 * i + 16), _mm_unpackhi_epi8(e2, e3));
+    }
+#endif
+    for (; i < n; i++) {
+        B = b[i + 1];
+        D = e[i];
+        E = e[i + 1];
+        F = e[i + 2];
+        H = h[i + 1];
+        top[2 * i] = (D == B && B != F && D != H) ? D : E;
+        top[2 * i + 1] = (B == F && B != D && F != H) ? F : E;
+        bot[2 * i] = (D == H && D != B && H != F) ? D : E;
+        bot[2 * i + 1] = (H == F && D != H && B != F) ? F : E;
+    }
+}
+
+// Scale2x the w x h pixels at x,y of the bw x bh bitmap at bits into dst,
+// which is for 2w x 2h.  Pixels past the edges of the bitmap count as
+// copies of the edge.
+void gr_flat8_to_argb_scale2x(uint32_t *dst, int pitch, uchar *bits, int row, int bw, int bh, int x, int y, int w,
+                              int h, uint32_t *pal) {
+    uchar b[SCALE_CHUNK + 2], e[SCALE_CHUNK + 2], hh[SCALE_CHUNK + 2], top[2 * SCALE_CHUNK], bot[2 * SCALE_CHUNK];
+    uchar *rb, *re, *rh;
+    int i, n, yy;
+
+    for (yy = y; yy < y + h; yy++) {
+        re = bits + yy * row;
+        rb = (yy > 0) ? re - row : re;
+        rh = (yy < bh - 1) ? re + row : re;
+        for (i = x; i < x + w; i += n) {
+            n = (x + w - i < SCALE_CHUNK) ? x + w - i : SCALE_CHUNK;
+            memcpy(b + 1, rb + i, n);
+            memcpy(e + 1, re + i, n);
+            memcpy(hh + 1, rh + i, n);
+            b[0] = rb[(i > 0) ? i - 1 : 0];
+            e[0] = re[(i > 0) ? i - 1 : 0];
+            hh[0] = rh[(i > 0) ? i - 1 : 0];
+            b[n + 1] = rb[(i + n < bw) ? i + n : bw - 1];
+            e[n + 1] = re[(i + n < bw) ? i + n : bw - 1];
+            hh[n + 1] = rh[(i + n < bw) ? i + n : bw - 1];
+            scale2x_row(b, e, hh, n, top, bot);
+            flat8_argb_row(dst + 2 * (i - x), top, 2 * n, pal);
+            flat8_argb_row((uint32_t *)((uchar *)dst + pitch) + 2 * (i - x), bot, 2 * n, pal);
+        }
+        dst = (uint32_t *)((uchar *)dst + 2 * pitch);
+    }
+}
@@ -383,10 +383,10 @@ void (*flat8_canvas_table[GRD_CANVAS_FUNCS])() = {
     gr_null,
     gr_null,
 
-    (ptr_type)gen_font_ustring, /* text/font functions. */
-    (ptr_type)gen_font_string,
-    (ptr_type)gen_font_scale_ustring,
-    (ptr_type)gen_font_scale_string,
+    (ptr_type)flat8_font_ustring, /* text/font functions. */
+    (ptr_type)flat8_font_string,
+    (ptr_type)flat8_font_scale_ustring,
+    (ptr_type)flat8_font_scale_string,
     (ptr_type)gen_font_uchar,
     (ptr_type)gen_font_char,
 
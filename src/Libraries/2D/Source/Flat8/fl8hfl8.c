@@ -37,6 +37,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  * Initial revision
  */
 
+#include "bitmap.h"
 #include "cnvdat.h"
 #include "flat8.h"
 
@@ -54,6 +55,20 @@ void flat8_hflip_flat8_ubitmap(grs_bitmap *bm, short x, short y) {
     h = bm->h;
     src = bm->bits;
     dst = grd_bm.bits + y * grow + x + bw - 1;
+    if (bm->flags & BMF_TRANS) {
+        while (h--) {
+            w = bw;
+            while (w--) {
+                if (*src)
+                    *dst = *src;
+                dst--;
+                src++;
+            }
+            src += brow - bw;
+            dst += grow + bw;
+        }
+        return;
+    }
     while (h--) {
         w = bw;
         while (w--)
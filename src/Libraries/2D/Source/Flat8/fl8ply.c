@@ -32,6 +32,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "lg.h"
 #include "poly.h"
 #include "tlucdat.h"
+#include "tluctab.h"
 #include "tmapint.h"
 #include <stdint.h>
 #include <string.h>
@@ -59,19 +60,15 @@ int gri_poly_loop(grs_tmap_loop_info *ti) {
 
     do {
         if ((d = fix_cint(ti_right_x) - fix_cint(ti_left_x)) > 0) {
-            int x;
-
             switch (ti_hlog) {
             case GRL_OPAQUE:
                 LG_memset(ti_d + fix_cint(ti_left_x), c, d);
                 break;
             case GRL_TLUC8:
-                for (x = fix_cint(ti_left_x); x < fix_cint(ti_right_x); x++)
-                    ti_d[x] = bm_bits[ti_d[x]];
+                gri_tluc8_span(ti_d + fix_cint(ti_left_x), d, bm_bits);
                 break;
             case GRL_CLUT | GRL_TLUC8:
-                for (x = fix_cint(ti_left_x); x < fix_cint(ti_right_x); x++)
-                    ti_d[x] = ti_clut[bm_bits[ti_d[x]]];
+                gri_tluc8_clut_span(ti_d + fix_cint(ti_left_x), d, bm_bits, ti_clut);
                 break;
             }
         } else if (d < 0) {
@@ -0,0 +1,317 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/*
+ * fl8spr.c
+ *
+ * Scaled transparent sprites into a flat 8 canvas.
+ *
+ * The 3d bitmap code hands every object and critter bitmap to the linear
+ * mapper as a quad, which steps u and v per pixel and tests every source
+ * pixel for transparency.  When the quad is an upright rectangle (no view
+ * bank) inside the clip, u steps the same way on every row, so here the
+ * source column for each canvas column is worked out once per sprite, and
+ * each canvas row only looks at the opaque runs of its source rows.  The
+ * runs come from a side table built when the bitmap is unpacked (see
+ * gr_rsd8_cache_convert_runs), and a run at 1:1 with no clut is a memcpy.
+ *
+ * This file is part of the 2d library.
+ *
+ */
+
+#include <string.h>
+#include "bitmap.h"
+#include "buffer.h"
+#include "clpcon.h"
+#include "cnvdat.h"
+#include "fill.h"
+#include "ifcn.h"
+#include "rsdunpck.h"
+#include "scrmac.h"
+#include "tmapfcn.h"
+
+/* The run table is h+1 uints, where entry y is the index of row y's first   */
+/* run in the ushort list that follows them, and entry h is the total.  Each */
+/* run is a start and end (exclusive) source column of nonzero pixels, and   */
+/* is only looked at for BMF_TRANS bitmaps.                                  */
+
+#define spr_run_list(runs, h) ((ushort *)((runs) + (h) + 1))
+
+int gr_sprite_runs_size(grs_bitmap *bm) {
+    int x, y, n = 0;
+    uchar *p;
+
+    for (y = 0; y < bm->h; y++) {
+        p = bm->bits + y * bm->row;
+        for (x = 0; x < bm->w; x++)
+            if ((p[x] != kSkipColor) && ((x == 0) || (p[x - 1] == kSkipColor)))
+                n++;
+    }
+    return (bm->h + 1) * sizeof(uint) + n * 2 * sizeof(ushort);
+}
+
+void gr_sprite_runs_make(grs_bitmap *bm, uint *runs) {
+    ushort *r = spr_run_list(runs, bm->h);
+    int x, y, n = 0;
+    uchar *p;
+
+    for (y = 0; y < bm->h; y++) {
+        runs[y] = n;
+        p = bm->bits + y * bm->row;
+        for (x = 0; x < bm->w;) {
+            if (p[x] == kSkipColor) {
+                x++;
+                continue;
+            }
+            r[n++] = x;
+            while ((x < bm->w) && (p[x] != kSkipColor))
+                x++;
+            r[n++] = x;
+        }
+    }
+    runs[bm->h] = n;
+}
+
+/* Draws canvas columns c0 to c1 (exclusive) of one row from source row src.  */
+/* Opaque bitmaps copy the lot, transparent ones only the runs from r to      */
+/* r_end, or test each pixel when there is no run table (r is NULL).          */
+static void spr_span(grs_bitmap *bm, uchar *dst, uchar *src, ushort *r, ushort *r_end, int *col, int *first,
+                     int c0, int c1, uchar unit, uchar *clut) {
+    int i, i0, i1;
+    uchar k;
+
+    if (!(bm->flags & BMF_TRANS)) {
+        i0 = c0;
+        i1 = c1;
+        r = r_end = NULL;
+    } else if (r == NULL) {
+        for (i = c0; i < c1; i++)
+            if ((k = src[col[i]]) != kSkipColor)
+                dst[i] = (clut == NULL) ? k : clut[k];
+        return;
+    } else {
+        if (r == r_end)
+            return;
+        i0 = first[r[0]];
+        i1 = first[r[1]];
+        r += 2;
+    }
+    // opaque runs, no tests
+    for (;;) {
+        if (i0 < c0)
+            i0 = c0;
+        if (i1 > c1)
+            i1 = c1;
+        if (i1 > i0) {
+            if (unit)
+                memcpy(dst + i0, src + col[i0], i1 - i0);
+            else if (clut == NULL)
+                for (i = i0; i < i1; i++)
+                    dst[i] = src[col[i]];
+            else
+                for (i = i0; i < i1; i++)
+                    dst[i] = clut[src[col[i]]];
+        }
+        if ((r == r_end) || (first[r[0]] >= c1))
+            break;
+        i0 = first[r[0]];
+        i1 = first[r[1]];
+        r += 2;
+    }
+}
+
+/* Fills in col, the source column of each of the n canvas columns starting */
+/* at u and stepping by du, and first, the first canvas column at or past    */
+/* each source column.  Returns whether the columns step one to one.         */
+static uchar spr_columns(grs_bitmap *bm, int *col, int *first, int n, fix u, fix du) {
+    int i, s;
+
+    for (i = 0; i < n; i++, u += du) {
+        col[i] = fix_fint(u);
+        if (col[i] >= bm->w)
+            col[i] = bm->w - 1;
+    }
+    for (s = 0, i = 0; s <= bm->w; s++) {
+        while ((i < n) && (col[i] < s))
+            i++;
+        first[s] = i;
+    }
+    return col[n - 1] - col[0] == n - 1;
+}
+
+/* Draws all of bm scaled into x0,y0 to x1,y1, sampling at the top left of   */
+/* each canvas pixel.  bm must be flat 8, runs can be NULL, and so can clut. */
+/* The runs are only used if bm is BMF_TRANS; otherwise every pixel is drawn. */
+int gr_scale_sprite(grs_bitmap *bm, uint *runs, fix x0, fix y0, fix x1, fix y1, uchar *clut) {
+    int xa, xb, ya, yb, n, y, sv;
+    int *col;
+    fix u, du, v, dv;
+    uchar *src, *dst, unit;
+
+    if ((x1 - x0 < FIX_UNIT) || (y1 - y0 < FIX_UNIT))
+        return CLIP_ALL;
+    du = fix_div(fix_make(bm->w, 0), x1 - x0);
+    dv = fix_div(fix_make(bm->h, 0), y1 - y0);
+
+    xa = fix_cint(x0);
+    xb = fix_cint(x1);
+    ya = fix_cint(y0);
+    yb = fix_cint(y1);
+    u = fix_mul(du, fix_ceil(x0) - x0);
+    v = fix_mul(dv, fix_ceil(y0) - y0);
+    if (xa < grd_clip.left) {
+        u += du * (grd_clip.left - xa);
+        xa = grd_clip.left;
+    }
+    if (ya < grd_clip.top) {
+        v += dv * (grd_clip.top - ya);
+        ya = grd_clip.top;
+    }
+    if (xb > grd_clip.right)
+        xb = grd_clip.right;
+    if (yb > grd_clip.bot)
+        yb = grd_clip.bot;
+    if ((xb <= xa) || (yb <= ya))
+        return CLIP_ALL;
+    n = xb - xa;
+
+    col = (int *)gr_alloc_temp((n + bm->w + 1) * sizeof(int));
+    if (col == NULL)
+        return CLIP_ALL;
+    unit = spr_columns(bm, col, col + n, n, u, du) && (clut == NULL);
+
+    dst = grd_bm.bits + ya * grd_bm.row + xa;
+    for (y = ya; y < yb; y++, v += dv, dst += grd_bm.row) {
+        sv = fix_fint(v);
+        if (sv >= bm->h)
+            sv = bm->h - 1;
+        src = bm->bits + sv * bm->row;
+        if (runs == NULL)
+            spr_span(bm, dst, src, NULL, NULL, col, col + n, 0, n, unit, clut);
+        else
+            spr_span(bm, dst, src, spr_run_list(runs, bm->h) + runs[sv], spr_run_list(runs, bm->h) + runs[sv + 1],
+                     col, col + n, 0, n, unit, clut);
+    }
+    gr_free_temp(col);
+    return CLIP_NONE;
+}
+
+/* Draws the upright quad the 3d bitmap code builds, stepping u and v just  */
+/* like h_map and the linear mapper do, so the result is the same pixel for */
+/* pixel.  u runs 0 to w-1 across each row, v runs 0 to h down the left    */
+/* edge but only to h-1 down the right, so v drops by under a texel across  */
+/* a row, and a row reads from one or two source rows.  The quad must be    */
+/* inside the clip rectangle, since the clipper would move its vertices.    */
+static int spr_quad(grs_bitmap *bm, uint *runs, grs_vertex **vpl, grs_tmap_info *ti, uchar *clut) {
+    fix x0 = vpl[0]->x, y0 = vpl[0]->y, frac, k, du, vl, dvl, vr, dvr, v, dv;
+    int xa, n, y, yb, c0, c1, sv;
+    int *col;
+    uchar *dst, *src, unit;
+    ushort *r, *r_end;
+
+    xa = fix_cint(x0);
+    n = fix_cint(vpl[1]->x) - xa;
+    y = fix_cint(y0);
+    yb = fix_cint(vpl[2]->y);
+    if ((n <= 0) || (yb <= y))
+        return CLIP_NONE;
+
+    // the edges, as gri_uvx_edge sets them up
+    frac = fix_ceil(y0) - y0;
+    dvl = fix_div(fix_make(bm->h, 0), vpl[2]->y - y0);
+    dvr = fix_div(fix_make(bm->h - 1, 0), vpl[2]->y - y0);
+    vl = fix_mul(frac, dvl);
+    vr = fix_mul(frac, dvr);
+
+    // and the steps along a row, as gri_lin_umap_loop does them
+    k = fix_div(fix_make(1, 0), vpl[1]->x - x0);
+    frac = fix_ceil(x0) - x0;
+    du = fix_mul_asm_safe(fix_make(bm->w - 1, 0), k);
+
+    col = (int *)gr_alloc_temp((n + bm->w + 1) * sizeof(int));
+    if (col == NULL)
+        return h_map(bm, 4, vpl, ti);
+    unit = spr_columns(bm, col, col + n, n, fix_mul(du, frac), du) && (clut == NULL);
+
+    dst = grd_bm.bits + y * grd_bm.row + xa;
+    for (; y < yb; y++, vl += dvl, vr += dvr, dst += grd_bm.row) {
+        dv = fix_mul_asm_safe(vr - vl, k);
+        v = vl + fix_mul(dv, frac);
+        for (c0 = 0; c0 < n; c0 = c1) {
+            // the mapper stops a row when v goes negative
+            if (v < 0)
+                break;
+            sv = fix_fint(v);
+            c1 = (dv < 0) ? c0 + (v - fix_make(sv, 0)) / -dv + 1 : n;
+            if (c1 > n)
+                c1 = n;
+            src = bm->bits + sv * bm->row;
+            r = r_end = NULL;
+            if (runs != NULL) {
+                r = spr_run_list(runs, bm->h) + runs[sv];
+                r_end = spr_run_list(runs, bm->h) + runs[sv + 1];
+            }
+            spr_span(bm, dst, src, r, r_end, col, col + n, c0, c1, unit, clut);
+            v += dv * (c1 - c0);
+        }
+    }
+    gr_free_temp(col);
+    return CLIP_NONE;
+}
+
+/* Drop in for h_map on the quads the 3d bitmap code builds.  Upright         */
+/* rectangles of plain or clut lit flat 8 (or unpackable rsd) bitmaps into a  */
+/* flat 8 canvas that need no clipping go through spr_quad, everything else, */
+/* stencil clipped canvases included, to h_map.                               */
+int gr_sprite_map(grs_bitmap *bm, int n, grs_vertex **vpl, grs_tmap_info *ti) {
+    grs_bitmap tbm;
+    uint *runs = NULL;
+    uchar *clut = NULL;
+    int ret;
+
+    if ((n != 4) || (grd_bm.type != BMT_FLAT8) || (grd_gc.fill_type != FILL_NORM) || (bm->flags & BMF_TLUC8) ||
+        (grd_clip.sten != NULL))
+        return h_map(bm, n, vpl, ti);
+    if (ti->tmap_type == GRC_CLUT_BILIN) {
+        if (!(ti->flags & TMF_CLUT))
+            return h_map(bm, n, vpl, ti);
+        if ((clut = ti->clut) == NULL)
+            clut = gr_get_clut();
+    } else if (ti->tmap_type != GRC_BILIN)
+        return h_map(bm, n, vpl, ti);
+    if ((vpl[0]->y != vpl[1]->y) || (vpl[2]->y != vpl[3]->y) || (vpl[0]->x != vpl[3]->x) || (vpl[1]->x != vpl[2]->x))
+        return h_map(bm, n, vpl, ti);
+    if ((vpl[0]->u != 0) || (vpl[0]->v != 0) || (vpl[1]->u != fix_make(bm->w - 1, 0)) || (vpl[1]->v != 0) ||
+        (vpl[2]->u != fix_make(bm->w - 1, 0)) || (vpl[2]->v != fix_make(bm->h - 1, 0)) || (vpl[3]->u != 0) ||
+        (vpl[3]->v != fix_make(bm->h, 0)))
+        return h_map(bm, n, vpl, ti);
+    if ((vpl[0]->x < grd_fix_clip.left) || (vpl[2]->x > grd_fix_clip.right) || (vpl[0]->y < grd_fix_clip.top) ||
+        (vpl[2]->y > grd_fix_clip.bot) || (vpl[2]->x <= vpl[0]->x) || (vpl[2]->y <= vpl[0]->y))
+        return h_map(bm, n, vpl, ti);
+
+    if (bm->type == BMT_FLAT8)
+        return spr_quad(bm, NULL, vpl, ti, clut);
+    if ((bm->type != BMT_RSD8) || (gr_rsd8_cache_convert_runs(bm, &tbm, &runs) != GR_UNPACK_RSD8_OK))
+        return h_map(bm, n, vpl, ti);
+    if (tbm.type == BMT_FLAT8)
+        ret = spr_quad(&tbm, runs, vpl, ti, clut);
+    else
+        ret = h_map(&tbm, n, vpl, ti);
+    gr_rsd8_cache_release(&tbm);
+    return ret;
+}
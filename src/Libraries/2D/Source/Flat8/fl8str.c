@@ -0,0 +1,237 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/*
+ * fl8str.c
+ *
+ * Cached strings for flat 8 canvases.
+ *
+ * The MFDs, status bar and inventory put the same few strings up every
+ * frame, and the generic string drawers go a character at a time, a mono
+ * character a bit at a time, and a scaled string through the general
+ * bitmap scaler a character at a time.  Here each string is drawn once by
+ * those same drawers into a bitmap of its own, for each font and size it
+ * is asked for in, and the opaque runs of that are kept, so from then on
+ * the string goes down as a memset per run in the current foreground color
+ * (mono fonts) or a memcpy per run (color fonts).  Strings that would be
+ * clipped, or are drawn in any fill mode but normal, go to the generic
+ * drawers.
+ *
+ * This file is part of the 2d library.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "bitmap.h"
+#include "canvas.h"
+#include "clpcon.h"
+#include "cnvdat.h"
+#include "ctxmac.h"
+#include "fill.h"
+#include "general.h"
+#include "grrect.h"
+#include "str.h"
+#include "tmapfcn.h"
+
+// how many strings we keep, and the longest one worth keeping
+#define FL8_TEXT_CNT 64
+#define FL8_TEXT_MAX_LEN 1024
+
+// same layout as the run tables in fl8spr.c
+#define text_run_list(runs, h) ((ushort *)((runs) + (h) + 1))
+
+typedef struct {
+   grs_font *f;      // font it was drawn in
+   grs_font head;    // and what that looked like, in case the memory goes to another font
+   short sw, sh;     // size it was scaled to, 0 if not scaled
+   uint hash;
+   char *s;          // the string
+   grs_bitmap bm;    // the string drawn at 0,0, 0 where there's nothing
+   uint *runs;       // bm's opaque runs
+   uint last_use;
+} fl8s_text;
+
+static fl8s_text fl8_text[FL8_TEXT_CNT];
+static uint fl8_text_clock;
+
+// Internal Prototypes
+static fl8s_text *fl8_get_text(grs_font *f, char *s, short sw, short sh);
+static void fl8_put_text(fl8s_text *t, short x, short y);
+
+static fl8s_text *fl8_get_text(grs_font *f, char *s, short sw, short sh)
+{
+   fl8s_text *t,*use = NULL;
+   grs_canvas cnv;
+   uint hash = 2166136261u;
+   int i,len;
+   short w,h;
+   char *mem;
+
+   for (len=0;s[len]!='\0';++len) {
+      if (len == FL8_TEXT_MAX_LEN)
+         return NULL;
+      hash = (hash ^ (uchar)s[len]) * 16777619u;
+   }
+
+   for (i=0;i<FL8_TEXT_CNT;++i) {
+      t = &fl8_text[i];
+      if ((t->f == f) && (t->hash == hash) && (t->sw == sw) && (t->sh == sh) && (strcmp(t->s,s) == 0)
+          && (memcmp(&t->head,f,sizeof(grs_font)) == 0)) {
+         t->last_use = ++fl8_text_clock;
+         return t;
+      }
+      if ((use == NULL) || (t->last_use < use->last_use))
+         use = t;
+   }
+
+   gr_font_string_size(f,s,&w,&h);
+   if ((w <= 0) || (h <= 0))
+      return NULL;
+   if (sw != 0) {
+      w = sw;
+      h = sh;
+   }
+
+   // draw it the slow way, mono fonts in color 1
+   free(use->s);
+   free(use->runs);
+   memset(use,0,sizeof(fl8s_text));
+   mem = (char *)malloc(len+1 + w*h);
+   if (mem == NULL)
+      return NULL;
+   use->s = mem;
+   memcpy(use->s,s,len+1);
+   gr_init_bm(&use->bm,(uchar *)mem+len+1,BMT_FLAT8,BMF_TRANS,w,h);
+   gr_make_canvas(&use->bm,&cnv);
+   gr_push_canvas(&cnv);
+   gr_clear(0);
+   gr_set_fcolor(1);
+   if (sw != 0)
+      gen_font_scale_string(f,s,0,0,sw,sh);
+   else
+      gen_font_string(f,s,0,0);
+   gr_pop_canvas();
+
+   // and its runs, so it never has to be looked at a pixel at a time again
+   use->runs = (uint *)malloc(gr_sprite_runs_size(&use->bm));
+   if (use->runs == NULL) {
+      free(use->s);
+      use->s = NULL;
+      return NULL;
+   }
+   gr_sprite_runs_make(&use->bm,use->runs);
+
+   use->f = f;
+   memcpy(&use->head,f,sizeof(grs_font));
+   use->sw = sw;
+   use->sh = sh;
+   use->hash = hash;
+   use->last_use = ++fl8_text_clock;
+   return use;
+}
+
+// put t down with its top left at x,y, no clipping
+static void fl8_put_text(fl8s_text *t, short x, short y)
+{
+   ushort *r,*r_end;
+   uchar *src,*dst;
+   uchar c = grd_gc.fcolor;
+   int i,j;
+
+   src = t->bm.bits;
+   dst = grd_bm.bits + y*grd_bm.row + x;
+   r = text_run_list(t->runs,t->bm.h);
+   for (j=0;j<t->bm.h;++j,src+=t->bm.row,dst+=grd_bm.row) {
+      // strokes are a few pixels wide, a loop beats a call at that size
+      r_end = text_run_list(t->runs,t->bm.h) + t->runs[j+1];
+      if (t->head.id == 0xcccc)
+         for (;r!=r_end;r+=2) {
+            if (r[1]-r[0] <= 8)
+               for (i=r[0];i<r[1];++i) dst[i] = src[i];
+            else
+               memcpy(dst+r[0],src+r[0],r[1]-r[0]);
+         }
+      else
+         for (;r!=r_end;r+=2) {
+            if (r[1]-r[0] <= 8)
+               for (i=r[0];i<r[1];++i) dst[i] = c;
+            else
+               memset(dst+r[0],c,r[1]-r[0]);
+         }
+   }
+}
+
+#define fl8_text_ok(t,x,y) \
+   ((x >= grd_clip.left) && (y >= grd_clip.top) && \
+    (x + (t)->bm.w <= grd_clip.right) && (y + (t)->bm.h <= grd_clip.bot))
+
+void flat8_font_ustring(grs_font *f, char *s, short x, short y)
+{
+   fl8s_text *t;
+
+   if ((grd_gc.fill_type == FILL_NORM) && ((t = fl8_get_text(f,s,0,0)) != NULL))
+      fl8_put_text(t,x,y);
+   else
+      gen_font_ustring(f,s,x,y);
+}
+
+int flat8_font_string(grs_font *f, char *s, short x, short y)
+{
+   fl8s_text *t;
+
+   if ((grd_gc.fill_type == FILL_NORM) && ((t = fl8_get_text(f,s,0,0)) != NULL) && fl8_text_ok(t,x,y)) {
+      fl8_put_text(t,x,y);
+      return CLIP_NONE;
+   }
+   return gen_font_string(f,s,x,y);
+}
+
+void flat8_font_scale_ustring(grs_font *f, char *s, short x, short y, short w, short h)
+{
+   fl8s_text *t;
+
+   if ((w > 0) && (h > 0) && (grd_gc.fill_type == FILL_NORM) && ((t = fl8_get_text(f,s,w,h)) != NULL))
+      fl8_put_text(t,x,y);
+   else
+      gen_font_scale_ustring(f,s,x,y,w,h);
+}
+
+int flat8_font_scale_string(grs_font *f, char *s, short x, short y, short w, short h)
+{
+   fl8s_text *t;
+
+   if ((w > 0) && (h > 0) && (grd_gc.fill_type == FILL_NORM) && ((t = fl8_get_text(f,s,w,h)) != NULL)
+       && fl8_text_ok(t,x,y)) {
+      fl8_put_text(t,x,y);
+      return CLIP_NONE;
+   }
+   return gen_font_scale_string(f,s,x,y,w,h);
+}
+
+// forget all the strings
+void flat8_free_text(void)
+{
+   int i;
+
+   for (i=0;i<FL8_TEXT_CNT;++i) {
+      free(fl8_text[i].s);
+      free(fl8_text[i].runs);
+      memset(&fl8_text[i],0,sizeof(fl8s_text));
+   }
+}
@@ -0,0 +1,122 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/*
+ * fl8tlsp.c
+ *
+ * Translucency span kernels for flat 8 canvases.
+ *
+ * A translucent pixel is just a table lookup on what is already in the
+ * canvas, d = tab[d], or for a bitmap, d = tluc8tab[s][d].  These run a
+ * span at a time instead of a pixel at a time: the canvas is read and
+ * written four pixels to a word, bitmap spans are cut into runs of one
+ * source color so the table is fetched once per run, and runs of
+ * transparent source are skipped without touching the canvas, sixteen at
+ * a time where SSE2 is around.
+ *
+ * This file is part of the 2d library.
+ */
+
+#include <string.h>
+#include "grs.h"
+#include "tluctab.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// d[i] = tab[d[i]]
+void gri_tluc8_span(uchar *d, int n, uchar *tab) {
+    uint32_t v;
+
+    for (; n >= 4; n -= 4, d += 4) {
+        memcpy(&v, d, 4);
+        v = tab[v & 0xff] | (tab[(v >> 8) & 0xff] << 8) | (tab[(v >> 16) & 0xff] << 16) |
+            ((uint32_t)tab[v >> 24] << 24);
+        memcpy(d, &v, 4);
+    }
+    while (n-- > 0) {
+        *d = tab[*d];
+        d++;
+    }
+}
+
+// d[i] = clut[tab[d[i]]]
+void gri_tluc8_clut_span(uchar *d, int n, uchar *tab, uchar *clut) {
+    uint32_t v;
+
+    for (; n >= 4; n -= 4, d += 4) {
+        memcpy(&v, d, 4);
+        v = clut[tab[v & 0xff]] | (clut[tab[(v >> 8) & 0xff]] << 8) | (clut[tab[(v >> 16) & 0xff]] << 16) |
+            ((uint32_t)clut[tab[v >> 24]] << 24);
+        memcpy(d, &v, 4);
+    }
+    while (n-- > 0) {
+        *d = clut[tab[*d]];
+        d++;
+    }
+}
+
+// how many leading source pixels are 0
+static int gri_tluc8_zero_run(uchar *s, int n) {
+    int i = 0;
+#ifdef __SSE2__
+    __m128i z = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        int m = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i *)(s + i)), z));
+        if (m != 0xffff)
+            return i + __builtin_ctz(~m);
+    }
+#endif
+    while ((i < n) && (s[i] == 0))
+        i++;
+    return i;
+}
+
+// a row of a translucent bitmap, each source color has its own table in tluc8tab,
+// colors with no table are opaque, if trans 0 is see through, clut may be NULL
+void gri_tluc8_bm_span(uchar *d, uchar *s, int n, uchar trans, uchar *clut) {
+    int i = 0;
+    uchar c, *tab;
+
+    while (i < n) {
+        c = s[i];
+        if ((c == 0) && trans) {
+            i += gri_tluc8_zero_run(s + i, n - i);
+            continue;
+        }
+        // one table fetch for the whole run of this color
+        tab = tluc8tab[c];
+        if (tab == NULL) {
+            c = (clut == NULL) ? c : clut[c];
+            do
+                d[i++] = c;
+            while ((i < n) && (s[i] == s[i - 1]));
+        } else if (clut == NULL) {
+            do {
+                d[i] = tab[d[i]];
+                i++;
+            } while ((i < n) && (s[i] == c));
+        } else {
+            do {
+                d[i] = clut[tab[d[i]]];
+                i++;
+            } while ((i < n) && (s[i] == c));
+        }
+    }
+}
@@ -303,4 +303,11 @@ extern void flat8_flat8_smooth_hv_double_ubitmap(grs_bitmap *src, grs_bitmap *ds
 extern void flat8_flat8_v_double_ubitmap(grs_bitmap *bm);
 extern void flat8_flat8_hv_double_ubitmap(grs_bitmap *bm);
 extern void flat8_flat8_smooth_v_double_ubitmap(grs_bitmap *bm);
+
+/* cached string routines. */
+extern void flat8_font_ustring(grs_font *f, char *s, short x, short y);
+extern int flat8_font_string(grs_font *f, char *s, short x, short y);
+extern void flat8_font_scale_ustring(grs_font *f, char *s, short x, short y, short w, short h);
+extern int flat8_font_scale_string(grs_font *f, char *s, short x, short y, short w, short h);
+extern void flat8_free_text(void);
 #endif /* !__FLAT8_H */
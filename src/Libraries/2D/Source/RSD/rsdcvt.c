@@ -43,15 +43,26 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "rsd.h"
 #define _RSDCVT_C
 #include "rsdunpck.h"
+#include "tmapfcn.h"
 #include "lg.h"
 
+#include <stdlib.h>
+
 uchar *grd_unpack_buf=NULL;
 
+static int rsd8_convert_to(grs_bitmap *sbm, grs_bitmap *dbm, uchar *buf);
+
 /*************************************************/
 /* Puts 0's in place of skips and pads with 0's. */
 /* i.e., grd_unpack_buf is entirely overwritten. */
 /*************************************************/
 int gr_rsd8_convert(grs_bitmap *sbm, grs_bitmap *dbm)
+{
+   if (grd_unpack_buf==NULL) return GR_UNPACK_RSD8_NOBUF;
+   return rsd8_convert_to(sbm,dbm,grd_unpack_buf);
+}
+
+static int rsd8_convert_to(grs_bitmap *sbm, grs_bitmap *dbm, uchar *buf)
 {
    short x_right,y_bot;                /* opposite edges of bitmap */
    short x,y;                          /* current position */
@@ -62,14 +73,13 @@ int gr_rsd8_convert(grs_bitmap *sbm, grs_bitmap *dbm)
    short rsd_count;                    /* count for last opcode */
    short op_count;                     /* operational count */
 
-   if (grd_unpack_buf==NULL) return GR_UNPACK_RSD8_NOBUF;
    if (sbm->type != BMT_RSD8) return GR_UNPACK_RSD8_NOTRSD;
    *dbm = *sbm;	// LG_memcpy (dbm, sbm, sizeof (*sbm));
    if (sbm->flags&BMF_TLUC8)
       dbm->type = BMT_TLUC8;
    else
       dbm->type = BMT_FLAT8;
-   dbm->bits = grd_unpack_buf;
+   dbm->bits = buf;
    if (dbm->w==dbm->row) p_dst=gr_rsd8_unpack(sbm->bits,dbm->bits);
    else {
       rsd_src = sbm->bits;
@@ -142,3 +152,244 @@ rsd_done:
    return GR_UNPACK_RSD8_OK;
 }
    
+
+/*************************************************/
+/* Decoded bitmap cache.                         */
+/* Same as gr_rsd8_convert, but keeps the        */
+/* unpacked bits around, keyed by the source     */
+/* bits pointer, so a bitmap drawn over and over */
+/* is unpacked once.  Only sources the owner     */
+/* routine vouches for are cached; the owner     */
+/* must then call gr_rsd8_cache_mem() for every  */
+/* block it hands out or takes back, so entries  */
+/* whose source goes away are dropped, and only  */
+/* those.  Anything else unpacks into            */
+/* grd_unpack_buf as before.  A hit or a new     */
+/* entry comes back pinned: its bits stay put    */
+/* until gr_rsd8_cache_release() no matter who   */
+/* else converts meanwhile.  Least recently used */
+/* unpinned entries go first when the size limit */
+/* is hit.  Flat 8 entries also get the opaque   */
+/* run table the sprite scaler uses, made once   */
+/* here rather than on every draw.               */
+/*************************************************/
+
+#define RSD8_CACHE_HASH 256
+#define RSD8_CACHE_DEF_SIZE (2*1024*1024)
+
+typedef struct _rsd8_cache_ent {
+   struct _rsd8_cache_ent *hnext;         /* hash chain */
+   struct _rsd8_cache_ent *lprev,*lnext;  /* lru chain, head is most recent */
+   uchar *src;                            /* source rsd bits */
+   short w,h,row;
+   short pins;                            /* callers still using the bits */
+   uchar dead;                            /* source gone, free on last release */
+   long size;
+   uint *runs;                            /* sprite run table, or NULL */
+   grs_bitmap bm;                         /* unpacked bitmap, bits follow entry */
+} rsd8_cache_ent;
+
+static rsd8_cache_ent *rsd8_hash[RSD8_CACHE_HASH];
+static rsd8_cache_ent *rsd8_lru_head=NULL, *rsd8_lru_tail=NULL;
+static uchar *rsd8_unowned[RSD8_CACHE_HASH];  /* sources the owner turned down */
+static long rsd8_cache_max=RSD8_CACHE_DEF_SIZE;
+static long rsd8_cache_bytes=0;
+static long rsd8_cache_hits=0, rsd8_cache_misses=0;
+static int (*rsd8_owner)(void *bits)=NULL;
+static volatile int rsd8_lock=0;
+
+#define rsd8_cache_lock()   while (__sync_lock_test_and_set(&rsd8_lock,1))
+#define rsd8_cache_unlock() __sync_lock_release(&rsd8_lock)
+#define rsd8_hash_idx(p)    ((((ulong)(p))>>4)&(RSD8_CACHE_HASH-1))
+
+static void rsd8_lru_unlink(rsd8_cache_ent *e)
+{
+   if (e->lprev) e->lprev->lnext=e->lnext; else rsd8_lru_head=e->lnext;
+   if (e->lnext) e->lnext->lprev=e->lprev; else rsd8_lru_tail=e->lprev;
+}
+
+static void rsd8_lru_front(rsd8_cache_ent *e)
+{
+   e->lprev=NULL;
+   e->lnext=rsd8_lru_head;
+   if (rsd8_lru_head) rsd8_lru_head->lprev=e; else rsd8_lru_tail=e;
+   rsd8_lru_head=e;
+}
+
+static void rsd8_cache_free(rsd8_cache_ent *e)
+{
+   rsd8_cache_bytes-=e->size;
+   if (e->runs) free(e->runs);
+   free(e);
+}
+
+/* takes e out of the cache; a pinned entry lingers until released */
+static void rsd8_cache_drop(rsd8_cache_ent *e)
+{
+   rsd8_cache_ent **pp=&rsd8_hash[rsd8_hash_idx(e->src)];
+   while (*pp!=e) pp=&(*pp)->hnext;
+   *pp=e->hnext;
+   rsd8_lru_unlink(e);
+   if (e->pins) e->dead=TRUE;
+   else rsd8_cache_free(e);
+}
+
+static void rsd8_cache_flush_locked(void)
+{
+   while (rsd8_lru_tail!=NULL)
+      rsd8_cache_drop(rsd8_lru_tail);
+}
+
+/* drops unpinned entries from the old end until size more bytes fit */
+static int rsd8_cache_make_room(long size)
+{
+   rsd8_cache_ent *e,*prev;
+
+   for (e=rsd8_lru_tail; (e!=NULL)&&(rsd8_cache_bytes+size>rsd8_cache_max); e=prev) {
+      prev=e->lprev;
+      if (e->pins==0) rsd8_cache_drop(e);
+   }
+   return (rsd8_cache_bytes+size<=rsd8_cache_max);
+}
+
+int gr_rsd8_cache_convert(grs_bitmap *sbm, grs_bitmap *dbm)
+{
+   return gr_rsd8_cache_convert_runs(sbm,dbm,NULL);
+}
+
+/* same, and if runs isn't NULL it gets the run table, NULL if there isn't one */
+int gr_rsd8_cache_convert_runs(grs_bitmap *sbm, grs_bitmap *dbm, uint **runs)
+{
+   rsd8_cache_ent *e;
+   long size,rsize;
+   int h;
+
+   if (runs) *runs=NULL;
+   if (sbm->type != BMT_RSD8) return GR_UNPACK_RSD8_NOTRSD;
+   size=(long)sbm->row*sbm->h;
+   if ((rsd8_owner==NULL)||(rsd8_cache_max==0)||(size>(rsd8_cache_max>>2)))
+      return gr_rsd8_convert(sbm,dbm);   /* off, or would thrash the cache */
+
+   rsd8_cache_lock();
+   h=rsd8_hash_idx(sbm->bits);
+   for (e=rsd8_hash[h]; e!=NULL; e=e->hnext)
+      if ((e->src==sbm->bits)&&(e->w==sbm->w)&&(e->h==sbm->h)&&(e->row==sbm->row))
+         break;
+   if (e!=NULL) {
+      rsd8_cache_hits++;
+      rsd8_lru_unlink(e);
+      rsd8_lru_front(e);
+      e->pins++;
+      *dbm=e->bm;
+      if (runs) *runs=e->runs;
+      rsd8_cache_unlock();
+      return GR_UNPACK_RSD8_OK;
+   }
+   rsd8_cache_misses++;
+   if ((rsd8_unowned[h]==sbm->bits)||!(*rsd8_owner)(sbm->bits)) {
+      rsd8_unowned[h]=sbm->bits;
+      rsd8_cache_unlock();
+      return gr_rsd8_convert(sbm,dbm);
+   }
+   e=NULL;
+   if (rsd8_cache_make_room(size))
+      e=(rsd8_cache_ent *)malloc(sizeof(rsd8_cache_ent)+size);
+   if (e==NULL) {
+      rsd8_cache_unlock();
+      return gr_rsd8_convert(sbm,dbm);
+   }
+   rsd8_convert_to(sbm,&e->bm,(uchar *)(e+1));
+   e->src=sbm->bits;
+   e->w=sbm->w;
+   e->h=sbm->h;
+   e->row=sbm->row;
+   e->pins=1;
+   e->dead=FALSE;
+   e->runs=NULL;
+   if (e->bm.type==BMT_FLAT8) {
+      rsize=gr_sprite_runs_size(&e->bm);
+      if ((e->runs=(uint *)malloc(rsize))!=NULL) {
+         gr_sprite_runs_make(&e->bm,e->runs);
+         size+=rsize;
+      }
+   }
+   e->size=size;
+   e->hnext=rsd8_hash[h];
+   rsd8_hash[h]=e;
+   rsd8_lru_front(e);
+   rsd8_cache_bytes+=size;
+   *dbm=e->bm;
+   if (runs) *runs=e->runs;
+   rsd8_cache_unlock();
+   return GR_UNPACK_RSD8_OK;
+}
+
+/* call once done with the bits from a successful cache convert */
+void gr_rsd8_cache_release(grs_bitmap *dbm)
+{
+   rsd8_cache_ent *e;
+
+   if ((dbm->bits==NULL)||(dbm->bits==grd_unpack_buf))
+      return;                            /* wasn't cached */
+   e=((rsd8_cache_ent *)dbm->bits)-1;
+   rsd8_cache_lock();
+   if ((--e->pins==0)&&e->dead)
+      rsd8_cache_free(e);
+   rsd8_cache_unlock();
+}
+
+/* owner says whether it will report the block holding bits through
+   gr_rsd8_cache_mem().  NULL, the default, caches nothing. */
+void gr_rsd8_cache_set_owner(int (*owner)(void *bits))
+{
+   rsd8_cache_lock();
+   rsd8_owner=owner;
+   rsd8_cache_flush_locked();
+   LG_memset(rsd8_unowned,0,sizeof(rsd8_unowned));
+   rsd8_cache_unlock();
+}
+
+/* the owner has taken back (gone) or handed out the block at base */
+void gr_rsd8_cache_mem(void *base, long size, uchar gone)
+{
+   rsd8_cache_ent *e,*prev;
+   uchar *lo=(uchar *)base, *hi=lo+size;
+
+   rsd8_cache_lock();
+   if (gone) {
+      for (e=rsd8_lru_tail; e!=NULL; e=prev) {
+         prev=e->lprev;
+         if ((e->src>=lo)&&(e->src<hi))
+            rsd8_cache_drop(e);
+      }
+   } else                                /* turned down sources may be in it now */
+      LG_memset(rsd8_unowned,0,sizeof(rsd8_unowned));
+   rsd8_cache_unlock();
+}
+
+/* max bytes of unpacked bits to hold on to, 0 turns the cache off */
+void gr_rsd8_cache_set_size(long bytes)
+{
+   rsd8_cache_lock();
+   rsd8_cache_max=bytes;
+   rsd8_cache_make_room(0);
+   rsd8_cache_unlock();
+}
+
+void gr_rsd8_cache_flush(void)
+{
+   rsd8_cache_lock();
+   rsd8_cache_flush_locked();
+   rsd8_cache_unlock();
+}
+
+/* any pointer can be NULL, clear resets the hit and miss counts */
+void gr_rsd8_cache_stats(long *hits, long *misses, long *bytes, uchar clear)
+{
+   rsd8_cache_lock();
+   if (hits) *hits=rsd8_cache_hits;
+   if (misses) *misses=rsd8_cache_misses;
+   if (bytes) *bytes=rsd8_cache_bytes;
+   if (clear) rsd8_cache_hits=rsd8_cache_misses=0;
+   rsd8_cache_unlock();
+}
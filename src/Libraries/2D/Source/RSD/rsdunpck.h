@@ -46,6 +46,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 extern uchar *grd_unpack_buf;
 extern int gr_rsd8_convert(grs_bitmap *sbm, grs_bitmap *dbm);
 // #endif
+#include "rsdcache.h"
 
 uchar *gr_rsd8_unpack(uchar* src, uchar *dst);
 
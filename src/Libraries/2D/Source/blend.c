@@ -27,6 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  * This file is part of the 2d library.
  */
 
+#include <string.h>
 #include "grs.h"
 #include "blncon.h"
 #include "grmalloc.h"
@@ -47,28 +48,34 @@ int grd_log_blend_levels=0;
 // blend fac is 0-256, where 0 is all 0, 256 is all 1
 void gri_build_blend(uchar *base_addr, int blend_fac)
 {
-   uchar *c=grd_ipal, *cur_addr=base_addr, cols[2][3];
+   uchar *c=grd_ipal, *cur_addr=base_addr, cols[256][3];
    int offs, i, j, k;                  /* offset from ipal for data, loop controls */
    int blend_bar=GR_BLEND_TABLE_RES-blend_fac;        /* remaining blend frac */
+   int bar[3];
+
+   // split the palette once, rather than once per pair
+   for (i=0; i<256; i++)
+      gr_split_rgb(grd_bpal[i],&cols[i][0],&cols[i][1],&cols[i][2]);
 
    for (i=0; i<256; i++)
    {
-      gr_split_rgb(grd_bpal[i],&cols[0][0],&cols[0][1],&cols[0][2]);
+      if ((i==0)||(cols[i][0]+cols[i][1]+cols[i][2]==0))
+      {
+         memset(cur_addr, i, 256);            // transparency and black are themselves, for zaniness w/shifts
+         cur_addr+=256;
+         continue;
+      }
+      for (k=0; k<3; k++)
+         bar[k]=cols[i][k]*blend_bar;
       for (j=0; j<256; j++)
       {
-         if ((i==0)||(i==j)||(cols[0][0]+cols[0][1]+cols[0][2]==0))
-            *cur_addr++=i;                    // transparency and self and black are themselves, for zaniness w/shifts
+         if ((i==j)||(j==0)||(cols[j][0]+cols[j][1]+cols[j][2]==0))
+            *cur_addr++=((i==j)?i:j);         // self is itself, and so are transparency and black
          else
          {
-		      gr_split_rgb(grd_bpal[j],&cols[1][0],&cols[1][1],&cols[1][2]);
-            if ((j==0)||(cols[1][0]+cols[1][1]+cols[1][2]==0))
-               *cur_addr++=j;
-            else
-            {
-			      for (offs=0, k=2; k>=0; k--)      // go do the blends
-		            offs=(offs<<5)+((((cols[0][k]*blend_bar)+(cols[1][k]*blend_fac))>>GR_BLEND_TABLE_RES_LOG)>>3);
-		         *cur_addr++=*(c+offs);
-            }
+		      for (offs=0, k=2; k>=0; k--)      // go do the blends
+		         offs=(offs<<5)+(((bar[k]+(cols[j][k]*blend_fac))>>GR_BLEND_TABLE_RES_LOG)>>3);
+		      *cur_addr++=*(c+offs);
          }
       }
    }
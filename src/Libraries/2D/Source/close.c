@@ -50,6 +50,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "grdev.h"
 #include "state.h"
 #include "close.h"
+#include "flat8.h"
 #include "status_2D.h"
 
 /* shut down 2d system.  call device-dependent shutdown routine and
@@ -60,6 +61,7 @@ int gr_close(void)
       return 0;
    gr_pop_video_state (TRUE);
    gr_close_device (&grd_info);
+   flat8_free_text ();
    grd_active = 0;
    return 0;
 }
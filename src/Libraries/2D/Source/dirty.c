@@ -0,0 +1,168 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+ 
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ 
+*/
+/*
+ * dirty.c
+ *
+ * Finding the parts of a flat 8 screen that changed since it was last shown.
+ *
+ * Everything that draws on the screen, the ui, the mfds, the 3d view blit,
+ * the cursor, movies, does it straight into the screen bits, so rather than
+ * have each of them say what they touched, the screen is compared against a
+ * copy of what was last handed over.  That's one byte a pixel read twice,
+ * which is a lot less than expanding every pixel to 32 bits and uploading it.
+ * When some colors change, only the pixels that are those colors have to be
+ * expanded again, and those are found the same way, sixteen at a time.
+ *
+ * This file is part of the 2d library.
+ *
+ */
+
+#include <string.h>
+#include "dirty.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define DIRTY_BAND 16 // rows compared as a unit
+#define DIRTY_GAP 32  // bands whose spans are this close go in one rect
+
+// the first and last+1 columns of a row that differ, to 8 pixels
+static void dirty_span(uchar *c, uchar *l, int w, int *lo, int *hi) {
+   int a = 0, b = w & ~7;
+   uint64_t x, y;
+
+   for (;; a += 8) {
+      if (a + 8 > w) break;
+      memcpy(&x, c + a, 8);
+      memcpy(&y, l + a, 8);
+      if (x != y) break;
+   }
+   if (b < w) b = w;
+   else
+      for (; b > a; b -= 8) {
+         memcpy(&x, c + b - 8, 8);
+         memcpy(&y, l + b - 8, 8);
+         if (x != y) break;
+      }
+   if (a < *lo) *lo = a;
+   if (b > *hi) *hi = b;
+}
+
+// add band y..yb with columns lo..hi to the n rects at r, carrying on the
+// rect above if it's close enough, or if we're out of them
+static void dirty_add(grs_rect *r, int *n, int max, int *open, int lo, int hi, int y, int yb) {
+   grs_rect *p;
+
+   if (lo >= hi) {
+      *open = 0;
+      return;
+   }
+   p = (*n > 0) ? &r[*n - 1] : r;
+   if ((*open && (lo < p->right + DIRTY_GAP) && (hi > p->left - DIRTY_GAP)) || (*n == max)) {
+      if (lo < p->left) p->left = lo;
+      if (hi > p->right) p->right = hi;
+      if (p->top > y) p->top = y;
+      p->bot = yb;
+   } else {
+      p = &r[(*n)++];
+      p->left = lo;
+      p->right = hi;
+      p->top = y;
+      p->bot = yb;
+   }
+   *open = 1;
+}
+
+// Compare the w x h screen at cur with last, both row bytes apart, and put
+// up to max rects [left,right) x [top,bot) around what changed in r.
+// Returns how many.
+int gr_dirty_find(uchar *cur, uchar *last, int row, int w, int h, grs_rect *r, int max) {
+   int n = 0, y, yb, j, lo, hi, open = 0;
+
+   for (y = 0; y < h; y += DIRTY_BAND) {
+      yb = (y + DIRTY_BAND < h) ? y + DIRTY_BAND : h;
+      lo = w;
+      hi = 0;
+      for (j = y; j < yb; j++)
+         if (memcmp(cur + j * row, last + j * row, w) != 0)
+            dirty_span(cur + j * row, last + j * row, w, &lo, &hi);
+      dirty_add(r, &n, max, &open, lo, hi, y, yb);
+   }
+   return n;
+}
+
+// widen lo..hi to take in the pixels of a row that are colors c0..c0+cn
+static void pal_span(uchar *c, int w, uchar c0, uchar cn, int *lo, int *hi) {
+   int x = 0, i, m;
+
+#if defined(__SSE2__)
+   __m128i v0 = _mm_set1_epi8(c0), vn = _mm_set1_epi8(cn), z = _mm_setzero_si128();
+   for (; x + 16 <= w; x += 16) {
+      // c - c0 <= cn, unsigned, is the same as the saturated difference being 0
+      __m128i v = _mm_sub_epi8(_mm_loadu_si128((__m128i *)(c + x)), v0);
+      m = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_subs_epu8(v, vn), z));
+      if (m == 0) continue;
+      if (x < *lo)
+         for (i = 0; i < 16; i++)
+            if (m & (1 << i)) {
+               if (x + i < *lo) *lo = x + i;
+               break;
+            }
+      for (i = 15; i >= 0; i--)
+         if (m & (1 << i)) {
+            if (x + i + 1 > *hi) *hi = x + i + 1;
+            break;
+         }
+   }
+#endif
+   for (; x < w; x++)
+      if ((uchar)(c[x] - c0) <= cn) {
+         if (x < *lo) *lo = x;
+         if (x + 1 > *hi) *hi = x + 1;
+      }
+}
+
+// Put up to max rects around the pixels of the w x h screen at cur that are
+// colors c0 to c1, for when those colors change but the pixels don't.
+// Returns how many.
+int gr_dirty_find_pal(uchar *cur, int row, int w, int h, int c0, int c1, grs_rect *r, int max) {
+   int n = 0, y, yb, j, lo, hi, open = 0;
+
+   if ((c0 > c1) || (max <= 0))
+      return 0;
+   for (y = 0; y < h; y += DIRTY_BAND) {
+      yb = (y + DIRTY_BAND < h) ? y + DIRTY_BAND : h;
+      lo = w;
+      hi = 0;
+      for (j = y; j < yb; j++)
+         pal_span(cur + j * row, w, c0, c1 - c0, &lo, &hi);
+      dirty_add(r, &n, max, &open, lo, hi, y, yb);
+   }
+   return n;
+}
+
+// copy what's in the rects from cur to last, once it's been shown
+void gr_dirty_keep(uchar *cur, uchar *last, int row, grs_rect *r, int n) {
+   int y;
+
+   for (; n > 0; n--, r++)
+      for (y = r->top; y < r->bot; y++)
+         memcpy(last + y * row + r->left, cur + y * row + r->left, r->right - r->left);
+}
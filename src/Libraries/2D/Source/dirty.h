@@ -0,0 +1,41 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+ 
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ 
+*/
+/*
+ * dirty.h
+ *
+ * Finding the parts of a flat 8 screen that changed since it was last shown.
+ *
+ * This file is part of the 2d library.
+ *
+ */
+
+#ifndef _DIRTY_H
+#define _DIRTY_H
+
+#include "fix.h"
+
+typedef struct {
+   short left, top, right, bot;
+} grs_rect;
+
+extern int gr_dirty_find(uchar *cur, uchar *last, int row, int w, int h, grs_rect *r, int max);
+extern int gr_dirty_find_pal(uchar *cur, int row, int w, int h, int c0, int c1, grs_rect *r, int max);
+extern void gr_dirty_keep(uchar *cur, uchar *last, int row, grs_rect *r, int n);
+
+#endif
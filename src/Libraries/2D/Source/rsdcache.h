@@ -0,0 +1,41 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+ 
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ 
+*/
+/*
+ * rsdcache.h
+ *
+ * The cache of unpacked rsd bitmaps in rsdcvt.c.  2d.h and rsdunpck.h both
+ * pull this in, so whatever includes it has grs_bitmap already.
+ *
+ * This file is part of the 2d library.
+ *
+ */
+
+#ifndef _RSDCACHE_H
+#define _RSDCACHE_H
+
+extern int gr_rsd8_cache_convert(grs_bitmap *sbm, grs_bitmap *dbm);
+extern int gr_rsd8_cache_convert_runs(grs_bitmap *sbm, grs_bitmap *dbm, uint **runs);
+extern void gr_rsd8_cache_release(grs_bitmap *dbm);
+extern void gr_rsd8_cache_set_owner(int (*owner)(void *bits));
+extern void gr_rsd8_cache_mem(void *base, long size, uchar gone);
+extern void gr_rsd8_cache_set_size(long bytes);
+extern void gr_rsd8_cache_flush(void);
+extern void gr_rsd8_cache_stats(long *hits, long *misses, long *bytes, uchar clear);
+
+#endif
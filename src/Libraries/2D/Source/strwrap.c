@@ -58,6 +58,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  * 
 */
 
+#include <stdlib.h>
+#include <string.h>
 #include "lg_types.h"
 #include "chr.h"
 #include "ctxmac.h"
@@ -71,6 +73,27 @@ static short *pCharPixOff;		// ptr to char offset table, with pfont->minch
 
 #define FONT_SETFONT(pfont) (pCharPixOff = &(pfont)->off_tab[0] - (pfont)->min)
 
+//	The MFDs wrap the same strings to the same widths every frame, and
+//	unwrap them again after, so the last few wraps are kept, and one
+//	that's been done before is just copied back.
+
+#define WRAP_CACHE_CNT 16
+#define WRAP_CACHE_MAX_LEN 2048	// longer than this, just wrap it
+
+typedef struct {
+	grs_font *pfont;			// font it was wrapped in
+	grs_font head;				// and what that looked like
+	short width;
+	short numLines;
+	int len;
+	char *before;				// the string as it came in
+	char *after;				// and with soft cr's and spaces in
+	uint lastUse;
+} WrapCache;
+
+static WrapCache wrapCache[WRAP_CACHE_CNT];
+static uint wrapClock;
+
 //	----------------------------------------------------
 //
 //	FontWrapText() inserts wrapping codes into text.
@@ -91,6 +114,38 @@ int gr_font_string_wrap (grs_font *pfont, char *ps, short width)
 	char *pmark;
 	short numLines;
 	short currWidth;
+	WrapCache *pwc,*puse;
+	char *ps0;
+	int len,i;
+
+//	Seen this one before?
+
+	len = strlen(ps);
+	puse = NULL;
+	for (i = 0; i < WRAP_CACHE_CNT; i++)
+		{
+		pwc = &wrapCache[i];
+		if ((pwc->pfont == pfont) && (pwc->width == width) && (pwc->len == len) &&
+			(memcmp(pwc->before, ps, len) == 0) && (memcmp(&pwc->head, pfont, sizeof(grs_font)) == 0))
+			{
+			memcpy(ps, pwc->after, len);
+			pwc->lastUse = ++wrapClock;
+			return(pwc->numLines);
+			}
+		if ((puse == NULL) || (pwc->lastUse < puse->lastUse))
+			puse = pwc;
+		}
+
+//	No, keep what it looks like now
+
+	free(puse->before);
+	memset(puse, 0, sizeof(WrapCache));
+	if ((len <= WRAP_CACHE_MAX_LEN) && ((puse->before = (char *) malloc(2 * len)) != NULL))
+		{
+		memcpy(puse->before, ps, len);
+		puse->after = puse->before + len;
+		}
+	ps0 = ps;
 
 //	Set up to do wrapping
 
@@ -165,6 +220,19 @@ int gr_font_string_wrap (grs_font *pfont, char *ps, short width)
 		++numLines;
 		}
 
+//	Keep the result for next time
+
+	if (puse->before)
+		{
+		memcpy(puse->after, ps0, len);
+		puse->pfont = pfont;
+		memcpy(&puse->head, pfont, sizeof(grs_font));
+		puse->width = width;
+		puse->numLines = numLines;
+		puse->len = len;
+		puse->lastUse = ++wrapClock;
+		}
+
 //	When hit end of string, return # lines encountered
 
 	return(numLines);
@@ -61,6 +61,11 @@ extern uchar *gr_init_lit_translucency_tables(uchar *p, fix opacity, fix purity,
 extern int gr_dump_tluc8_table(uchar *buf, int nlit);
 extern void gr_read_tluc8_table(uchar *buf);
 
+/* span kernels, in fl8tlsp.c */
+extern void gri_tluc8_span(uchar *d, int n, uchar *tab);
+extern void gri_tluc8_clut_span(uchar *d, int n, uchar *tab, uchar *clut);
+extern void gri_tluc8_bm_span(uchar *d, uchar *s, int n, uchar trans, uchar *clut);
+
 #define gr_alloc_translucency_table(n) \
    ((uchar *)malloc(n*256))
 #define gr_free_translucency_table(tab) (free(tab))
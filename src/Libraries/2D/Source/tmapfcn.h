@@ -42,4 +42,10 @@ extern int per_map(grs_bitmap *bm, int n, grs_vertex **vpl, grs_tmap_info *ti);
 extern int h_map(grs_bitmap *bm, int n, grs_vertex **vpl, grs_tmap_info *ti);
 extern int v_map(grs_bitmap *bm, int n, grs_vertex **vpl, grs_tmap_info *ti);
 
+/* sprite scaler, in fl8spr.c */
+extern int gr_sprite_runs_size(grs_bitmap *bm);
+extern void gr_sprite_runs_make(grs_bitmap *bm, uint *runs);
+extern int gr_scale_sprite(grs_bitmap *bm, uint *runs, fix x0, fix y0, fix x1, fix y1, uchar *clut);
+extern int gr_sprite_map(grs_bitmap *bm, int n, grs_vertex **vpl, grs_tmap_info *ti);
+
 #endif /* __TMAPFCN_H */
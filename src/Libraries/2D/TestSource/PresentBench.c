@@ -0,0 +1,306 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+// times getting an 8 bit frame into an SDL texture at a few screen sizes:
+// the palette expansion alone, a pixel at a time and with gr_flat8_to_argb,
+// then a texture made from the surface every frame like SDLDraw used to do
+// against one streaming texture filled in place, then the two output
+// scalers at the game's own screen sizes, and last a palette cycle.  Each
+// new way gets checked against the old one, or a plain loop doing the same
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "2d.h"
+#include "bench.h"
+
+#include <SDL.h>
+
+#define PASSES 20
+
+static int sizes[][2] = {{640, 480}, {1024, 768}, {1920, 1080}, {2560, 1440}, {3840, 2160}};
+#define SIZE_CNT (sizeof(sizes) / sizeof(sizes[0]))
+
+static uint32_t pal[256];
+static SDL_Color colors[256];
+
+// one screen size's worth of everything the timed runs draw from and into
+typedef struct {
+    int w, h, k;
+    SDL_Surface *src;
+    uchar *bits;
+    uint32_t *out, *cyc;
+    SDL_Renderer *ren;
+    SDL_Texture *tex;
+} frame;
+
+// the plain loops
+static void ref_expand(uint32_t *d, int pitch, uchar *s, int row, int w, int h) {
+    int x, y;
+    for (y = 0; y < h; y++, d = (uint32_t *)((uchar *)d + pitch), s += row)
+        for (x = 0; x < w; x++)
+            d[x] = pal[s[x]];
+}
+
+static void ref_scale(uint32_t *d, uchar *s, int w, int h, int k) {
+    int x, y;
+    for (y = 0; y < h * k; y++)
+        for (x = 0; x < w * k; x++)
+            d[y * w * k + x] = pal[s[(y / k) * w + x / k]];
+}
+
+static void ref_scale2x(uint32_t *d, uchar *s, int w, int h) {
+    int x, y;
+    uchar B, D, E, F, H;
+    for (y = 0; y < h; y++)
+        for (x = 0; x < w; x++) {
+            E = s[y * w + x];
+            B = s[((y > 0) ? y - 1 : y) * w + x];
+            H = s[((y < h - 1) ? y + 1 : y) * w + x];
+            D = s[y * w + ((x > 0) ? x - 1 : x)];
+            F = s[y * w + ((x < w - 1) ? x + 1 : x)];
+            d[2 * y * 2 * w + 2 * x] = pal[(D == B && B != F && D != H) ? D : E];
+            d[2 * y * 2 * w + 2 * x + 1] = pal[(B == F && B != D && F != H) ? F : E];
+            d[(2 * y + 1) * 2 * w + 2 * x] = pal[(D == H && D != B && H != F) ? D : E];
+            d[(2 * y + 1) * 2 * w + 2 * x + 1] = pal[(H == F && D != H && B != F) ? F : E];
+        }
+}
+
+static void run_ref_expand(void *data) {
+    frame *f = (frame *)data;
+    int k;
+    for (k = 0; k < bench_passes; k++)
+        ref_expand(f->out, f->w * 4, f->src->pixels, f->src->pitch, f->w, f->h);
+}
+
+static void run_expand(void *data) {
+    frame *f = (frame *)data;
+    int k;
+    for (k = 0; k < bench_passes; k++)
+        gr_flat8_to_argb(f->out, f->w * 4, f->src->pixels, f->src->pitch, f->w, f->h, pal);
+}
+
+static void upload_per_frame(frame *f) {
+    SDL_Texture *t = SDL_CreateTextureFromSurface(f->ren, f->src);
+    SDL_RenderCopy(f->ren, t, NULL, NULL);
+    SDL_DestroyTexture(t);
+}
+
+static void upload_streaming(frame *f) {
+    void *pixels;
+    int pitch;
+    if (SDL_LockTexture(f->tex, NULL, &pixels, &pitch) == 0) {
+        gr_flat8_to_argb(pixels, pitch, f->src->pixels, f->src->pitch, f->w, f->h, pal);
+        SDL_UnlockTexture(f->tex);
+    }
+    SDL_RenderCopy(f->ren, f->tex, NULL, NULL);
+}
+
+static void run_per_frame(void *data) {
+    int k;
+    for (k = 0; k < bench_passes; k++)
+        upload_per_frame((frame *)data);
+}
+
+static void run_streaming(void *data) {
+    int k;
+    for (k = 0; k < bench_passes; k++)
+        upload_streaming((frame *)data);
+}
+
+static void run_scale(void *data) {
+    frame *f = (frame *)data;
+    int k;
+    for (k = 0; k < bench_passes; k++)
+        gr_flat8_to_argb_scale(f->out, f->w * 4 * f->k, f->bits, f->w, f->w, f->h, pal, f->k);
+}
+
+static void run_scale2x(void *data) {
+    frame *f = (frame *)data;
+    int k;
+    for (k = 0; k < bench_passes; k++)
+        gr_flat8_to_argb_scale2x(f->out, f->w * 8, f->bits, f->w, f->w, f->h, 0, 0, f->w, f->h, pal);
+}
+
+static void run_expand_cyc(void *data) {
+    frame *f = (frame *)data;
+    int k;
+    for (k = 0; k < bench_passes; k++)
+        gr_flat8_to_argb(f->out, f->w * 4, f->bits, f->w, f->w, f->h, f->cyc);
+}
+
+// the screen as it was shown before the colors moved
+static void prep_dirty_cyc(void *data) {
+    frame *f = (frame *)data;
+    gr_flat8_to_argb(f->out, f->w * 4, f->bits, f->w, f->w, f->h, pal);
+}
+
+static void run_dirty_cyc(void *data) {
+    frame *f = (frame *)data;
+    grs_rect dirty[8];
+    int k, j, n, w = f->w, at;
+    for (k = 0; k < bench_passes; k++) {
+        n = gr_dirty_find_pal(f->bits, w, w, f->h, 0x03, 0x1f, dirty, 8);
+        for (j = 0; j < n; j++) {
+            at = dirty[j].top * w + dirty[j].left;
+            gr_flat8_to_argb(f->out + at, w * 4, f->bits + at, w, dirty[j].right - dirty[j].left,
+                             dirty[j].bot - dirty[j].top, f->cyc);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    SDL_Surface *target;
+    SDL_Palette *spal;
+    frame f;
+    uint32_t *check;
+    int i, k, r, j, bad = 0;
+    double ref_ms, exp_ms, old_ms, new_ms;
+
+    bench_args(argc, argv, PASSES);
+    for (i = 0; i < 256; i++) {
+        colors[i].r = i;
+        colors[i].g = (i * 3) & 0xff;
+        colors[i].b = 255 - i;
+        colors[i].a = 0xff;
+        pal[i] = (0xff << 24) | (colors[i].r << 16) | (colors[i].g << 8) | colors[i].b;
+    }
+    spal = SDL_AllocPalette(256);
+    SDL_SetPaletteColors(spal, colors, 0, 256);
+
+    printf("ms per frame     plain loop   gr_flat8_to_argb   texture per frame   streaming texture\n");
+    for (i = 0; i < SIZE_CNT; i++) {
+        f.w = sizes[i][0];
+        f.h = sizes[i][1];
+        f.src = SDL_CreateRGBSurface(0, f.w, f.h, 8, 0, 0, 0, 0);
+        SDL_SetSurfacePalette(f.src, spal);
+        for (k = 0; k < f.src->pitch * f.h; k++)
+            ((uchar *)f.src->pixels)[k] = (k * 7 + k / 5) & 0xff;
+        f.out = (uint32_t *)malloc(f.w * f.h * 4);
+        check = (uint32_t *)malloc(f.w * f.h * 4);
+
+        ref_ms = bench_time(NULL, run_ref_expand, &f) / bench_passes;
+        memcpy(check, f.out, f.w * f.h * 4);
+        exp_ms = bench_time(NULL, run_expand, &f) / bench_passes;
+        bad |= bench_differ(f.out, check, f.w * f.h * 4, "%dx%d: gr_flat8_to_argb and the plain loop disagree!", f.w,
+                            f.h);
+
+        // the whole trip through a renderer, a software one so it runs anywhere
+        target = SDL_CreateRGBSurfaceWithFormat(0, f.w, f.h, 32, SDL_PIXELFORMAT_ARGB8888);
+        f.ren = SDL_CreateSoftwareRenderer(target);
+        old_ms = new_ms = 0;
+        if (f.ren != NULL) {
+            f.tex = SDL_CreateTexture(f.ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, f.w, f.h);
+            old_ms = bench_time(NULL, run_per_frame, &f) / bench_passes;
+            new_ms = bench_time(NULL, run_streaming, &f) / bench_passes;
+
+            // and one frame each way has to land the same on the target
+            SDL_FillRect(target, NULL, 0);
+            upload_per_frame(&f);
+            SDL_RenderPresent(f.ren);
+            for (k = 0; k < f.h; k++)
+                memcpy(check + k * f.w, (uchar *)target->pixels + k * target->pitch, f.w * 4);
+            SDL_FillRect(target, NULL, 0);
+            upload_streaming(&f);
+            SDL_RenderPresent(f.ren);
+            for (k = 0; k < f.h; k++)
+                memcpy(f.out + k * f.w, (uchar *)target->pixels + k * target->pitch, f.w * 4);
+            bad |= bench_differ(f.out, check, f.w * f.h * 4, "%dx%d: the streaming texture shows something else!",
+                                f.w, f.h);
+
+            SDL_DestroyTexture(f.tex);
+            SDL_DestroyRenderer(f.ren);
+        }
+
+        printf("%4dx%-4d    %10.3f %18.3f %19.3f %19.3f\n", f.w, f.h, ref_ms, exp_ms, old_ms, new_ms);
+        SDL_FreeSurface(target);
+        SDL_FreeSurface(f.src);
+        free(f.out);
+        free(check);
+    }
+
+    printf("\nms per frame     x2 nearest   x3 nearest   scale2x\n");
+    for (i = 0; i < 2; i++) {
+        f.w = sizes[i][0];
+        f.h = sizes[i][1];
+        f.bits = (uchar *)malloc(f.w * f.h);
+        f.out = (uint32_t *)malloc(f.w * f.h * 4 * 9);
+        check = (uint32_t *)malloc(f.w * f.h * 4 * 9);
+        // big flat areas and diagonal edges, more like the game than noise is
+        for (k = 0; k < f.w * f.h; k++)
+            f.bits[k] = ((k % f.w) / 8 + (k / f.w) / 6) & 0x0f;
+
+        f.k = 2;
+        ref_ms = bench_time(NULL, run_scale, &f) / bench_passes;
+        ref_scale(check, f.bits, f.w, f.h, 2);
+        bad |= bench_differ(f.out, check, f.w * f.h * 4 * 4, "%dx%d: x2 nearest and the plain loop disagree!", f.w,
+                            f.h);
+        f.k = 3;
+        exp_ms = bench_time(NULL, run_scale, &f) / bench_passes;
+        ref_scale(check, f.bits, f.w, f.h, 3);
+        bad |= bench_differ(f.out, check, f.w * f.h * 4 * 9, "%dx%d: x3 nearest and the plain loop disagree!", f.w,
+                            f.h);
+        old_ms = bench_time(NULL, run_scale2x, &f) / bench_passes;
+        ref_scale2x(check, f.bits, f.w, f.h);
+        bad |= bench_differ(f.out, check, f.w * f.h * 4 * 4, "%dx%d: scale2x and the plain loop disagree!", f.w, f.h);
+
+        printf("%4dx%-4d    %10.3f %12.3f %9.3f\n", f.w, f.h, ref_ms, exp_ms, old_ms);
+        free(f.bits);
+        free(f.out);
+        free(check);
+    }
+
+    // a bank of colors cycling, like the lights and water do all through a
+    // level: the whole screen expanded again, against finding where those
+    // colors are and expanding just that
+    printf("\nms per frame     all again   cycled colors only\n");
+    for (i = 0; i < 2; i++) {
+        static uint32_t cyc[256];
+        f.w = sizes[i][0];
+        f.h = sizes[i][1];
+        f.bits = (uchar *)malloc(f.w * f.h);
+        f.out = (uint32_t *)malloc(f.w * f.h * 4);
+        f.cyc = cyc;
+        check = (uint32_t *)malloc(f.w * f.h * 4);
+        // walls and floor, with a few lights and a pool in the cycling colors
+        for (k = 0; k < f.w * f.h; k++)
+            f.bits[k] = 0x40 + (((k % f.w) / 8 + (k / f.w) / 6) & 0x3f);
+        for (k = 0; k < 6; k++)
+            for (r = 0; r < f.h / 12; r++)
+                for (j = 0; j < f.w / 16; j++)
+                    f.bits[(f.h / 8 + (k % 3) * f.h / 4 + r) * f.w + (k / 3) * f.w / 2 + f.w / 8 + j] =
+                        0x03 + ((r + j) % 29);
+        memcpy(cyc, pal, sizeof(cyc));
+        for (k = 0x03; k <= 0x1f; k++)
+            cyc[k] = pal[0x03 + (k - 0x03 + 1) % 29];
+
+        ref_ms = bench_time(NULL, run_expand_cyc, &f) / bench_passes;
+        memcpy(check, f.out, f.w * f.h * 4);
+        exp_ms = bench_time(prep_dirty_cyc, run_dirty_cyc, &f) / bench_passes;
+        bad |= bench_differ(f.out, check, f.w * f.h * 4, "%dx%d: expanding just the cycled colors missed some!", f.w,
+                            f.h);
+        printf("%4dx%-4d    %10.3f %20.3f\n", f.w, f.h, ref_ms, exp_ms);
+        free(f.bits);
+        free(f.out);
+        free(check);
+    }
+
+    SDL_FreePalette(spal);
+    return bad;
+}
@@ -0,0 +1,208 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+// times a crowd of scaled, clut lit, transparent sprites, drawn the old way
+// through the linear mapper and through the sprite scaler in fl8spr.c, and
+// checks gr_sprite_map against the mapper and gr_scale_sprite against a
+// plain pixel at a time scaling loop, with and without BMF_TRANS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "grs.h"
+#include "bitmap.h"
+#include "canvas.h"
+#include "ifcn.h"
+#include "init_2D.h"
+#include "tmapfcn.h"
+#include "bench.h"
+
+#define SCR_W 1024
+#define SCR_H 768
+#define SPR_W 64
+#define SPR_H 96
+#define SPR_CNT 400
+#define PASSES 10
+
+static uchar screen[SCR_W * SCR_H], check[SCR_W * SCR_H];
+static uchar sprite_bits[SPR_W * SPR_H], clut[256];
+static uint *sprite_runs;
+static grs_bitmap sprite;
+static grs_canvas can;
+static fix spr_x[SPR_CNT], spr_y[SPR_CNT], spr_sz[SPR_CNT];
+
+// a critter sort of shape, a blob with arms and a few holes, the rest see through
+static void make_sprite(void) {
+    int x, y, dx, dy;
+    for (y = 0; y < SPR_H; y++)
+        for (x = 0; x < SPR_W; x++) {
+            dx = x - SPR_W / 2;
+            dy = y - SPR_H / 2;
+            if ((dx * dx * 4 + dy * dy < 40 * 40) && (((x / 5 + y / 7) % 6) != 0))
+                sprite_bits[y * SPR_W + x] = 16 + ((x * 3 + y) & 0x7f);
+            else if ((y > 30) && (y < 38) && ((x < 8) || (x > SPR_W - 8)))
+                sprite_bits[y * SPR_W + x] = 200;
+            else
+                sprite_bits[y * SPR_W + x] = 0;
+        }
+    gr_init_bm(&sprite, sprite_bits, BMT_FLAT8, BMF_TRANS, SPR_W, SPR_H);
+    sprite_runs = (uint *)malloc(gr_sprite_runs_size(&sprite));
+    gr_sprite_runs_make(&sprite, sprite_runs);
+}
+
+// the quad the 3d bitmap code would build for this sprite
+static void make_quad(grs_vertex *v, grs_vertex **vpl, fix x0, fix y0, fix x1, fix y1) {
+    int i;
+    for (i = 0; i < 4; i++) {
+        vpl[i] = &v[i];
+        v[i].w = v[i].i = 0;
+    }
+    v[0].x = v[3].x = x0;
+    v[1].x = v[2].x = x1;
+    v[0].y = v[1].y = y0;
+    v[2].y = v[3].y = y1;
+    v[0].u = v[3].u = 0;
+    v[1].u = v[2].u = fix_make(SPR_W - 1, 0);
+    v[0].v = v[1].v = 0;
+    v[2].v = fix_make(SPR_H - 1, 0);
+    v[3].v = fix_make(SPR_H, 0);
+}
+
+// the scaler's mapping, a pixel at a time with a test per pixel
+static void ref_scale(fix x0, fix y0, fix x1, fix y1) {
+    fix du = fix_div(fix_make(SPR_W, 0), x1 - x0), dv = fix_div(fix_make(SPR_H, 0), y1 - y0), u, v;
+    int x, y, xa = fix_cint(x0), ya = fix_cint(y0), sv, su;
+    uchar k;
+
+    v = fix_mul(dv, fix_ceil(y0) - y0);
+    for (y = ya; y < fix_cint(y1); y++, v += dv) {
+        u = fix_mul(du, fix_ceil(x0) - x0);
+        for (x = xa; x < fix_cint(x1); x++, u += du) {
+            if ((x < 0) || (x >= SCR_W) || (y < 0) || (y >= SCR_H))
+                continue;
+            su = (fix_fint(u) < SPR_W) ? fix_fint(u) : SPR_W - 1;
+            sv = (fix_fint(v) < SPR_H) ? fix_fint(v) : SPR_H - 1;
+            if (((k = sprite_bits[sv * SPR_W + su]) != 0) || !(sprite.flags & BMF_TRANS))
+                check[y * SCR_W + x] = clut[k];
+        }
+    }
+}
+
+#define DRAW_MAPPER 0
+#define DRAW_SPRITE 1
+#define DRAW_SCALE 2
+static void draw_one(int how, int i) {
+    grs_vertex v[4], *vpl[4];
+    grs_tmap_info ti;
+    fix x1 = spr_x[i] + fix_mul(spr_sz[i], fix_make(SPR_W, 0));
+    fix y1 = spr_y[i] + fix_mul(spr_sz[i], fix_make(SPR_H, 0));
+
+    ti.tmap_type = GRC_CLUT_BILIN;
+    ti.flags = TMF_CLUT;
+    ti.clut = clut;
+    switch (how) {
+    case DRAW_MAPPER:
+        make_quad(v, vpl, spr_x[i], spr_y[i], x1, y1);
+        h_map(&sprite, 4, vpl, &ti);
+        break;
+    case DRAW_SPRITE:
+        make_quad(v, vpl, spr_x[i], spr_y[i], x1, y1);
+        gr_sprite_map(&sprite, 4, vpl, &ti);
+        break;
+    case DRAW_SCALE:
+        gr_scale_sprite(&sprite, sprite_runs, spr_x[i], spr_y[i], x1, y1, clut);
+        break;
+    }
+}
+
+static void clear_screen(void *data) { memset(screen, 1, sizeof(screen)); }
+
+static void draw(void *data) {
+    int i, k;
+    for (k = 0; k < bench_passes; k++)
+        for (i = 0; i < SPR_CNT; i++)
+            draw_one(*(int *)data, i);
+}
+
+static double time_draw(int how) { return bench_time(clear_screen, draw, &how); }
+
+// draws every sprite once with how and once with ref, or the reference
+// loop if ref is -1, and compares
+static int check_draw(int how, int ref, const char *msg) {
+    int i;
+
+    memset(screen, 1, sizeof(screen));
+    memset(check, 1, sizeof(check));
+    for (i = 0; i < SPR_CNT; i++)
+        if (ref < 0)
+            ref_scale(spr_x[i], spr_y[i], spr_x[i] + fix_mul(spr_sz[i], fix_make(SPR_W, 0)),
+                      spr_y[i] + fix_mul(spr_sz[i], fix_make(SPR_H, 0)));
+        else
+            draw_one(ref, i);
+    if (ref >= 0)
+        memcpy(check, screen, sizeof(check));
+    memset(screen, 1, sizeof(screen));
+    for (i = 0; i < SPR_CNT; i++)
+        draw_one(how, i);
+    return bench_differ(screen, check, sizeof(screen), "%s", msg);
+}
+
+int main(int argc, char *argv[]) {
+    grs_bitmap scr_bm;
+    double map_ms, spr_ms, scl_ms;
+    int i, bad;
+
+    bench_args(argc, argv, PASSES);
+    gr_init();
+    gr_init_bm(&scr_bm, screen, BMT_FLAT8, 0, SCR_W, SCR_H);
+    gr_make_canvas(&scr_bm, &can);
+    gr_set_canvas(&can);
+    for (i = 0; i < 256; i++)
+        clut[i] = (i * 5 + 1) & 0xff;
+    make_sprite();
+
+    // far off ones small, a few up close and hanging off the edges
+    srand(3);
+    for (i = 0; i < SPR_CNT; i++) {
+        spr_sz[i] = (i % 10 == 0) ? fix_make(2, rand() & 0xffff) : fix_make(0, 0x4000 + (rand() & 0xbfff));
+        spr_x[i] = fix_make(rand() % (SCR_W + 64) - 64, rand() & 0xffff);
+        spr_y[i] = fix_make(rand() % (SCR_H + 96) - 96, rand() & 0xffff);
+    }
+
+    map_ms = time_draw(DRAW_MAPPER);
+    spr_ms = time_draw(DRAW_SPRITE);
+    scl_ms = time_draw(DRAW_SCALE);
+
+    printf("%d sprites x %d passes\n", SPR_CNT, bench_passes);
+    printf("linear mapper    %8.2fms\n", map_ms);
+    printf("no run table     %8.2fms   x%.2f\n", spr_ms, map_ms / spr_ms);
+    printf("with run table   %8.2fms   x%.2f\n", scl_ms, map_ms / scl_ms);
+
+    // one pass of each against what it should match, first as the game's
+    // transparent sprites, then opaque, where index 0 gets drawn too
+    bad = 0;
+    for (i = 0; i < 2; i++) {
+        sprite.flags = (i == 0) ? BMF_TRANS : 0;
+        bad |= check_draw(DRAW_SPRITE, DRAW_MAPPER, "gr_sprite_map and h_map disagree!");
+        bad |= check_draw(DRAW_SCALE, -1, "gr_scale_sprite and reference loop disagree!");
+    }
+
+    free(sprite_runs);
+    return bad;
+}
@@ -0,0 +1,176 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+// times an MFD's worth of labels drawn every frame, in a mono and a color
+// font, plain and scaled, through the generic string drawers and through
+// the cached ones in fl8str.c, and checks they leave the same pixels
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "2d.h"
+#include "bench.h"
+
+// the generic drawers, which general.h can't be included next to 2d.h for
+extern int gen_font_string(grs_font *f, char *s, short x, short y);
+extern int gen_font_scale_string(grs_font *f, char *s, short x, short y, short w, short h);
+
+#define SCR_W 640
+#define SCR_H 480
+#define FONT_MIN 32
+#define FONT_MAX 127
+#define FONT_H 8
+#define PASSES 50
+
+static uchar screen[SCR_W * SCR_H], check[SCR_W * SCR_H];
+static grs_canvas can;
+static grs_font *mono_font, *color_font;
+
+static char *labels[] = {"ENERGY", "SHIELD", "STATUS: NOMINAL", "TARGET: SERV-BOT", "RANGE 12.5m",
+                         "DAMAGE: MODERATE", "AMMO 24/50", "MAGPULSE RIFLE", "LEVEL 3 - RESEARCH",
+                         "CYBERSPACE", "BIO: 82 bpm", "FATIGUE 12%", "RADIATION: 0 rads", "AUTOMAP",
+                         "E-MAIL: Rebecca", "INVENTORY", "HARDWARE", "SOFTWARE", "PATCHES", "GRENADES"};
+#define LABEL_CNT (sizeof(labels) / sizeof(labels[0]))
+
+// widths 3 to 7 and some bit pattern in each, like a small font would have
+static grs_font *make_font(int color) {
+    int n = FONT_MAX - FONT_MIN + 1, off[FONT_MAX - FONT_MIN + 2], i, x, y, w, row;
+    int head = sizeof(grs_font) + n * sizeof(short);
+    grs_font *f;
+    uchar *bits;
+
+    for (i = 0, w = 0; i < n; i++) {
+        off[i] = w;
+        w += 3 + (i * 7) % 5;
+    }
+    off[n] = w;
+    row = color ? w : (w + 7) / 8;
+    f = (grs_font *)calloc(1, head + row * FONT_H);
+    f->id = color ? 0xcccc : 0;
+    f->min = FONT_MIN;
+    f->max = FONT_MAX;
+    f->buf = head;
+    f->w = row;
+    f->h = FONT_H;
+    for (i = 0; i <= n; i++)
+        f->off_tab[i] = off[i];
+    bits = (uchar *)f + head;
+    for (i = 0; i < n; i++)
+        for (y = 1; y < FONT_H - 1; y++)
+            for (x = off[i]; x < off[i + 1] - 1; x++)
+                if (((x * 5 + y * 3 + i) % 7) < 4) {
+                    if (color)
+                        bits[y * row + x] = 32 + ((x + y) & 0x1f);
+                    else
+                        bits[y * row + (x >> 3)] |= 0x80 >> (x & 7);
+                }
+    return f;
+}
+
+// a column of labels in a few colors, some of them hanging off the edge
+static void draw_labels(grs_font *f, int scaled, int cached) {
+    int i, x, y;
+    short w, h;
+
+    for (i = 0; i < 4 * LABEL_CNT; i++) {
+        x = (i * 37) % SCR_W - 20;
+        y = (i * 23) % SCR_H - 4;
+        gr_set_fcolor(1 + i % 200);
+        if (scaled) {
+            gr_font_string_size(f, labels[i % LABEL_CNT], &w, &h);
+            if (cached)
+                gr_font_scale_string(f, labels[i % LABEL_CNT], x, y, w * 2, h * 2);
+            else
+                gen_font_scale_string(f, labels[i % LABEL_CNT], x, y, w * 2, h * 2);
+        } else if (cached)
+            gr_font_string(f, labels[i % LABEL_CNT], x, y);
+        else
+            gen_font_string(f, labels[i % LABEL_CNT], x, y);
+    }
+}
+
+typedef struct {
+    grs_font *f;
+    int scaled, cached;
+} draw_args;
+
+static void draw_passes(void *data) {
+    draw_args *a = (draw_args *)data;
+    int k;
+    for (k = 0; k < bench_passes; k++)
+        draw_labels(a->f, a->scaled, a->cached);
+}
+
+static double time_draw(grs_font *f, int scaled, int cached) {
+    draw_args a = {f, scaled, cached};
+    return bench_time(NULL, draw_passes, &a) / bench_passes;
+}
+
+int main(int argc, char *argv[]) {
+    static char *font_names[] = {"mono", "color"};
+    grs_bitmap scr_bm;
+    grs_font *f;
+    double gen_ms, cache_ms;
+    int i, scaled, bad = 0;
+    char wrap[256], first[256];
+    short lines;
+
+    bench_args(argc, argv, PASSES);
+    gr_init();
+    gr_init_bm(&scr_bm, screen, BMT_FLAT8, 0, SCR_W, SCR_H);
+    gr_make_canvas(&scr_bm, &can);
+    gr_set_canvas(&can);
+    mono_font = make_font(FALSE);
+    color_font = make_font(TRUE);
+
+    printf("%d labels, ms per frame\n", 4 * (int)LABEL_CNT);
+    for (i = 0; i < 2; i++) {
+        f = (i == 0) ? mono_font : color_font;
+        for (scaled = 0; scaled < 2; scaled++) {
+            gen_ms = time_draw(f, scaled, FALSE);
+            cache_ms = time_draw(f, scaled, TRUE);
+
+            gr_clear(0);
+            draw_labels(f, scaled, FALSE);
+            memcpy(check, screen, sizeof(check));
+            gr_clear(0);
+            draw_labels(f, scaled, TRUE);
+            bad |= bench_differ(check, screen, sizeof(check), "%s %s: the cached strings came out different!",
+                                font_names[i], scaled ? "x2" : "x1");
+            printf("%-5s %s   generic %7.3fms   cached %7.3fms   x%.1f\n", font_names[i], scaled ? "x2" : "x1",
+                   gen_ms, cache_ms, gen_ms / cache_ms);
+        }
+    }
+
+    // a wrap that comes out of the cache must be the same as the first one
+    strcpy(wrap, "TARGET: SERV-BOT  RANGE 12.5m  DAMAGE: MODERATE  MAGPULSE RIFLE  AMMO 24/50");
+    lines = gr_font_string_wrap(mono_font, wrap, 80);
+    strcpy(first, wrap);
+    for (i = 0; i < 3; i++) {
+        gr_font_string_unwrap(wrap);
+        if ((gr_font_string_wrap(mono_font, wrap, 80) != lines) || (strcmp(wrap, first) != 0)) {
+            printf("wrapping the same string twice came out different!\n");
+            bad = 1;
+        }
+    }
+
+    free(mono_font);
+    free(color_font);
+    return bad;
+}
@@ -0,0 +1,163 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+// times full screen translucent fills, the old pixel at a time loops against
+// the span kernels in fl8tlsp.c, and checks they draw the same thing
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "grs.h"
+#include "tluctab.h"
+#include "bench.h"
+
+#define SCR_W 1280
+#define SCR_H 960
+#define PASSES 20
+
+static uchar tab[256], clut[256], tab_mem[4][256];
+static uchar *screen, *check, *sprite;
+
+static void ref_span(uchar *d, int n, uchar *t) {
+    int i;
+    for (i = 0; i < n; i++)
+        d[i] = t[d[i]];
+}
+
+static void ref_clut_span(uchar *d, int n, uchar *t, uchar *c) {
+    int i;
+    for (i = 0; i < n; i++)
+        d[i] = c[t[d[i]]];
+}
+
+static void ref_bm_span(uchar *d, uchar *s, int n) {
+    int i;
+    for (i = 0; i < n; i++)
+        if (s[i] != 0) {
+            if (tluc8tab[s[i]] == NULL)
+                d[i] = s[i];
+            else
+                d[i] = tluc8tab[s[i]][d[i]];
+        }
+}
+
+static void fill_screen(uchar *p) {
+    int i;
+    srand(1);
+    for (i = 0; i < SCR_W * SCR_H; i++)
+        p[i] = rand() & 0xff;
+}
+
+// draw bench_passes full screens of one kind of fill, old loops or new spans
+#define FILL_TLUC 0
+#define FILL_CLUT 1
+#define FILL_BM 2
+static void draw(uchar *p, int fill, int spans) {
+    int k, y;
+    for (k = 0; k < bench_passes; k++)
+        for (y = 0; y < SCR_H; y++) {
+            uchar *d = p + y * SCR_W;
+            switch (fill) {
+            case FILL_TLUC:
+                if (spans)
+                    gri_tluc8_span(d, SCR_W, tab);
+                else
+                    ref_span(d, SCR_W, tab);
+                break;
+            case FILL_CLUT:
+                if (spans)
+                    gri_tluc8_clut_span(d, SCR_W, tab, clut);
+                else
+                    ref_clut_span(d, SCR_W, tab, clut);
+                break;
+            case FILL_BM:
+                if (spans)
+                    gri_tluc8_bm_span(d, sprite + y * SCR_W, SCR_W, TRUE, NULL);
+                else
+                    ref_bm_span(d, sprite + y * SCR_W, SCR_W);
+                break;
+            }
+        }
+}
+
+typedef struct {
+    uchar *p;
+    int fill, spans;
+} fill_args;
+
+static void fill_prep(void *data) { fill_screen(((fill_args *)data)->p); }
+
+static void fill_run(void *data) {
+    fill_args *a = (fill_args *)data;
+    draw(a->p, a->fill, a->spans);
+}
+
+// in milliseconds, each run leaves its screen drawn for checking
+static double time_fill(uchar *p, int fill, int spans) {
+    fill_args a = {p, fill, spans};
+    return bench_time(fill_prep, fill_run, &a);
+}
+
+static void report(const char *what, double ref_ms, double new_ms) {
+    double mpix = (double)SCR_W * SCR_H * bench_passes / 1000000.0;
+    printf("%-16s pixel loop %8.2fms (%7.1f Mpix/s)   spans %8.2fms (%7.1f Mpix/s)   x%.2f\n", what, ref_ms,
+           mpix / (ref_ms / 1000.0), new_ms, mpix / (new_ms / 1000.0), ref_ms / new_ms);
+}
+
+int main(int argc, char *argv[]) {
+    static const char *names[3] = {"tluc poly", "clut tluc poly", "tluc8 bitmap"};
+    int i, k, fill, bad = 0;
+    double ref_ms, new_ms;
+
+    bench_args(argc, argv, PASSES);
+    screen = (uchar *)malloc(SCR_W * SCR_H);
+    check = (uchar *)malloc(SCR_W * SCR_H);
+    sprite = (uchar *)malloc(SCR_W * SCR_H);
+    for (i = 0; i < 256; i++) {
+        tab[i] = (i * 7 + 3) & 0xff;
+        clut[i] = 255 - i;
+        for (k = 0; k < 4; k++)
+            tab_mem[k][i] = (i + k * 64) & 0xff;
+    }
+    // a force field sort of sprite, big see through patches, runs of a few tluc colors and some opaque bits
+    for (k = 0; k < 4; k++)
+        tluc8tab[k + 1] = tab_mem[k];
+    srand(2);
+    for (i = 0; i < SCR_W * SCR_H;) {
+        int run = 1 + (rand() & 31), c = rand() % 8;
+        if (c > 5)
+            c = 0;
+        else if (c == 5)
+            c = 200;
+        for (k = 0; (k < run) && (i < SCR_W * SCR_H); k++)
+            sprite[i++] = c;
+    }
+
+    for (fill = FILL_TLUC; fill <= FILL_BM; fill++) {
+        ref_ms = time_fill(check, fill, FALSE);
+        new_ms = time_fill(screen, fill, TRUE);
+        bad |= bench_differ(screen, check, SCR_W * SCR_H, "%s: spans and pixel loop disagree!", names[fill]);
+        report(names[fill], ref_ms, new_ms);
+    }
+
+    free(screen);
+    free(check);
+    free(sprite);
+    return bad;
+}
@@ -0,0 +1,76 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+// what the timing programs share, see bench.h
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "lg_types.h"
+#include "bench.h"
+
+#include <SDL.h>
+
+// the 2d library wants these from whoever owns the screen, we never show anything
+long gScreenRowbytes;
+Ptr gScreenAddress;
+void SetSDLPalette(int index, int count, uchar *pal) {}
+
+int bench_reps = BENCH_REPS, bench_passes = 1;
+
+void bench_args(int argc, char *argv[], int passes) {
+    int i;
+
+    bench_passes = passes;
+    for (i = 1; i < argc; i++)
+        if (strcmp(argv[i], "-check") == 0)
+            bench_reps = bench_passes = 1;
+}
+
+// best of bench_reps runs, in milliseconds, with prep (if any) done before
+// each one and left out of the time
+double bench_time(bench_func prep, bench_func run, void *data) {
+    int r;
+    double ms, best = 0;
+    Uint64 start;
+
+    for (r = 0; r < bench_reps; r++) {
+        if (prep != NULL)
+            prep(data);
+        start = SDL_GetPerformanceCounter();
+        run(data);
+        ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+        if ((r == 0) || (ms < best))
+            best = ms;
+    }
+    return best;
+}
+
+// says so and returns 1 if the n bytes at a and b aren't the same
+int bench_differ(const void *a, const void *b, size_t n, const char *fmt, ...) {
+    va_list ap;
+
+    if (memcmp(a, b, n) == 0)
+        return 0;
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    printf("\n");
+    return 1;
+}
@@ -0,0 +1,47 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/*
+ * bench.h
+ *
+ * What the timing programs share: the screen hooks the 2d library wants
+ * from whoever owns the screen, best of a few timed runs, and checking
+ * the old and new ways of drawing something came out the same.
+ *
+ * Run with -check to just draw everything once and compare, which is what
+ * the tests do.
+ *
+ */
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+#include <stddef.h>
+
+#define BENCH_REPS 5
+
+// runs to take the best of, and how many passes each run should draw
+extern int bench_reps, bench_passes;
+
+typedef void (*bench_func)(void *data);
+
+extern void bench_args(int argc, char *argv[], int passes);
+extern double bench_time(bench_func prep, bench_func run, void *data);
+extern int bench_differ(const void *a, const void *b, size_t n, const char *fmt, ...);
+
+#endif
@@ -79,8 +79,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "OpenGL.h"
 #include <stdbool.h>
 
-// need this from 2D lib
+// need these from 2D lib
 extern int h_map(grs_bitmap *bm, int n, grs_vertex **vpl, grs_tmap_info *ti);
+extern int gr_sprite_map(grs_bitmap *bm, int n, grs_vertex **vpl, grs_tmap_info *ti);
 
 fix _g3d_bitmap_x_scale = 0x010000;
 fix _g3d_bitmap_y_scale = 0x010000;
@@ -406,7 +407,8 @@ grs_vertex **g3_bitmap_common(grs_bitmap *bm, g3s_phandle p) {
     tmap_info.tmap_type = (_g3d_light_flag << 1) + GRC_BILIN;
     extern bool use_opengl();
     if (!use_opengl()) {
-        h_map(bm, 4, _g3d_bitmap_poly, &tmap_info);
+        // with no bank the quad is an upright rectangle, which the sprite scaler does much faster
+        gr_sprite_map(bm, 4, _g3d_bitmap_poly, &tmap_info);
     } else {
         int opengl_bitmap(grs_bitmap *bm, int n, grs_vertex **vpl, grs_tmap_info *ti);
         opengl_bitmap(bm, 4, _g3d_bitmap_poly, &tmap_info);
@@ -146,7 +146,6 @@ int check_linear(int w);
 #define _bm_h 10
 
 void *tmap_func;
-grs_bitmap unpack_bm;
 grs_tmap_info ti;
 grs_tmap_info *ti_ptr = &ti;
 
@@ -374,9 +373,10 @@ int g3_draw_tmap(int n, g3s_phandle *vp, grs_bitmap *bm) {
 
 int do_tmap(int n, g3s_phandle *vp, grs_bitmap *bm) {
     byte andcode, orcode;
-    int i;
+    int i, ret;
     g3s_phandle *src;
     g3s_phandle tempHand;
+    grs_bitmap unpack_bm;
 
 // clang-format off
 #ifdef stereo_on
@@ -423,14 +423,6 @@ no_stereo1:
 
         // clang-format on
 
-        // convert RSD bitmap to normal
-        if (bm->type == BMT_RSD8) {
-        if (gr_rsd8_convert(bm, &unpack_bm) != GR_UNPACK_RSD8_OK)
-            return CLIP_ALL;
-        else
-            bm = &unpack_bm;
-    }
-
     // get codes for this polygon
     andcode = 0xff;
     orcode = 0;
@@ -445,7 +437,14 @@ no_stereo1:
     if (andcode)
         return CLIP_ALL;
 
-    return (draw_tmap_common(n, vp, bm));
+    // convert RSD bitmap to normal, holding on to it until drawn
+    if (bm->type != BMT_RSD8)
+        return (draw_tmap_common(n, vp, bm));
+    if (gr_rsd8_cache_convert(bm, &unpack_bm) != GR_UNPACK_RSD8_OK)
+        return CLIP_ALL;
+    ret = draw_tmap_common(n, vp, &unpack_bm);
+    gr_rsd8_cache_release(&unpack_bm);
+    return (ret);
 }
 
 // draws a square texture map, where the corners of the 3d quad match the
@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *
  */
 
+#include <string.h>
 #include "palette.h"
 
 /*
@@ -92,7 +93,7 @@ byte num_installed_shifts = 0;
 void palette_advance_all_fx(long timestamp)
 {
    static int	ts_remainder = 0;   
-   int         	i, time_diff;
+   int         	i, time_diff, changed;
    short		c1, c2, t;
    int         	steps_to_do;
    div_t 		result;
@@ -135,12 +136,15 @@ void palette_advance_all_fx(long timestamp)
 			palette_advance_effect(i, steps_to_do);
 		}
 	}
+	// most steps move nothing, the banks cycle much slower than we're called
+	changed = (memcmp(local_smap, grd_pal, sizeof(local_smap)) != 0);
 	if (Palette_Effects_Table[0].effect == CBANK) {
 		gr_set_pal((int)c1, (int)(c2 - c1 +1), &local_smap[c1*3]);
    }
 
    // CC: refresh the whole palette
-   gr_set_pal(0, 256, local_smap);
+   if (changed)
+      gr_set_pal(0, 256, local_smap);
 }
 
 uchar c_off_stack[3];
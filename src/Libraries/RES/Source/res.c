@@ -50,6 +50,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 ResDesc *gResDesc;   // ptr to array of resource descriptors
 ResDesc2 *gResDesc2; // secondary array, shared buff with resdesc
 Id resDescMax;       // max id in res desc
+uint32_t resGeneration; // bumped whenever resource memory is freed or replaced
+ResMemHook resMemHook;  // told about each resource block coming and going
 // default max resource id
 #define DEFAULT_RESMAX 32767
 // grow by blocks of 1024 resources must be power of 2!
@@ -132,6 +134,36 @@ void ResTerm() {
     TRACE("%s: RES system terminated", __FUNCTION__);
 }
 
+//	---------------------------------------------------------
+//
+//	ResSetMemHook() installs the routine told about resource
+//	memory blocks coming and going, NULL for none.
+
+void ResSetMemHook(ResMemHook hook) { resMemHook = hook; }
+
+//	---------------------------------------------------------
+//
+//	ResPtrId() finds which resource in memory a pointer lies in.
+//	This walks the whole descriptor table, so callers should
+//	remember the answer.
+//
+//		p = pointer to look up
+//
+//	Returns: id of resource holding p, or 0 if none does
+
+Id ResPtrId(void *p) {
+    ResDesc *prd;
+    int32_t id;
+
+    for (id = ID_MIN; id <= resDescMax; id++) {
+        prd = RESDESC(id);
+        if ((prd->ptr != NULL) && ((uint8_t *)p >= (uint8_t *)prd->ptr) &&
+            ((uint8_t *)p < (uint8_t *)prd->ptr + prd->size))
+            return ((Id)id);
+    }
+    return (0);
+}
+
 //	---------------------------------------------------------
 //
 //	ResGrowResDescTable() grows resource descriptor table to
@@ -110,6 +110,17 @@ void *ResExtract(Id id, void *buffer); // extract resource into buffer
 void ResDrop(Id id);                   // drop resource from immediate use
 void ResDelete(Id id);                 // delete resource forever
 
+// Goes up every time resource memory is freed or its contents replaced, so anyone caching
+// things derived from resource data by address knows an address may now mean something else
+extern uint32_t resGeneration;
+
+// Called with a resource's memory block once it belongs to the resource (gone FALSE), and
+// again just before it is freed, moved or rewritten (gone TRUE), so a cache keyed on addresses
+// inside resources can drop only what went away
+typedef void (*ResMemHook)(void *ptr, int32_t size, bool gone);
+void ResSetMemHook(ResMemHook hook);
+Id ResPtrId(void *p); // id of the in-memory resource holding p, or 0 if none
+
 //	------------------------------------------------------------
 //		ACCESS TO ITEMS IN COMPOUND RESOURCES (REF'S)  (refacc.c)
 //	------------------------------------------------------------
@@ -62,6 +62,15 @@ extern Id idBeingLoaded;
 #define RES_PAGER(size) (*f_pager)(size)
 */
 
+//	Memory block notification (res.c)
+
+extern ResMemHook resMemHook;
+#define ResMemNotify(ptr, size, gone)       \
+    {                                       \
+        if (resMemHook != NULL)             \
+            (*resMemHook)(ptr, size, gone); \
+    }
+
 //	Grow descriptor table (res.c)
 
 void ResGrowResDescTable(Id id);
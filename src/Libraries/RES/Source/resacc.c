@@ -202,8 +202,10 @@ void ResDrop(Id id) {
     }
 
     if (prd->ptr != NULL) {
+        ResMemNotify(prd->ptr, prd->size, TRUE);
         free(prd->ptr);
         prd->ptr = NULL;
+        resGeneration++;
     }
 }
 
@@ -198,6 +198,7 @@ void ResKill(Id id) {
     if (prd->ptr) {
         if (prd->lock == 0)
             ResRemoveFromLRU(prd);
+        ResMemNotify(prd->ptr, prd->size, TRUE);
     }
     memset(prd, 0, sizeof(ResDesc));
 
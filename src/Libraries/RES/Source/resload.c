@@ -79,6 +79,7 @@ void *ResLoadResource(Id id) {
     prd->ptr = malloc(prd->size);
     if (prd->ptr == NULL)
         return (NULL);
+    ResMemNotify(prd->ptr, prd->size, FALSE);
 
     // Load from disk
     ResRetrieve(id, prd->ptr);
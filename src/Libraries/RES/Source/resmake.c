@@ -72,6 +72,7 @@ void ResMake(Id id, void *ptr, int32_t size, uint8_t type, int32_t filenum, uint
     }
 
     // Add us to the soup, set lock so doesn't get swapped out
+    resGeneration++;
     prd->ptr = ptr;
     prd->size = size;
     prd->filenum = filenum;
@@ -79,6 +80,7 @@ void ResMake(Id id, void *ptr, int32_t size, uint8_t type, int32_t filenum, uint
     prd->offset = RES_OFFSET_PENDING;
     prd2->flags = flags;
     prd2->type = type;
+    ResMemNotify(ptr, size, FALSE);
 }
 
 //	---------------------------------------------------------------
@@ -130,11 +132,13 @@ void ResAddRef(Ref ref, void *pitem, int32_t itemSize) {
     TRACE("%s: adding ref $%x\n", __FUNCTION__, ref);
 
     prd = RESDESC(REFID(ref));
+    resGeneration++; // items move around, and may be realloced
 
     prt = (RefTable *)prd->ptr;
     if (prt == NULL) {
         prt = (RefTable *)RefGet(ref);
     }
+    ResMemNotify(prd->ptr, prd->size, TRUE);
 
     // If index within current range of compound resource, replace or insert
     index = REFINDEX(ref);
@@ -200,6 +204,7 @@ void ResAddRef(Ref ref, void *pitem, int32_t itemSize) {
         memcpy(REFPTR(prt, index), pitem, itemSize);
         prt->numRefs = index + 1;
     }
+    ResMemNotify(prd->ptr, prd->size, FALSE);
 }
 
 //	-------------------------------------------------------------
@@ -216,4 +221,10 @@ void ResAddRef(Ref ref, void *pitem, int32_t itemSize) {
 //  For Mac version: use ReleaseResource to free the handle (the pointer that
 //  the handle was made from will still be around).
 
-void ResUnmake(Id id) { memset(RESDESC(id), 0, sizeof(ResDesc)); }
\ No newline at end of file
+void ResUnmake(Id id) {
+    ResDesc *prd = RESDESC(id);
+
+    if (prd->ptr)
+        ResMemNotify(prd->ptr, prd->size, TRUE);
+    memset(prd, 0, sizeof(ResDesc));
+}
\ No newline at end of file
@@ -54,6 +54,17 @@ void vx_init_vox(vxs_vox *v,fix pix_dist,fix pix_size,int depth,grs_bitmap *col,
 // don't forget to call g3_end_object afterwards
 void vx_render(vxs_vox *v);
 
+// The 2d half of vx_render, x0,y0 is the screen spot of texel 0,0 at height 0
+// and the rest are screen steps per column, row and height, dotw and doth is
+// the dot size in pixels, and clip is set if it might go off the canvas.
+// vmap_dot draws texel by texel, vmap_dot_list draws from a list of the
+// opaque texels kept between frames, and gives the same picture
+void vmap_dot(fix x0, fix y0, fix dxdu, fix dydu, fix dxdv, fix dydv, fix dxdz, fix dydz, int near_ver,vxs_vox *vx,int dotw,int doth,uchar clip);
+void vmap_dot_list(fix x0, fix y0, fix dxdu, fix dydu, fix dxdv, fix dydv, fix dxdz, fix dydz, int near_ver,vxs_vox *vx,int dotw,int doth,uchar clip);
+
+// Throw away the kept dot lists, vx_close does this too
+void vx_free_dots();
+
 
 #endif /* !__VOX_H */
 
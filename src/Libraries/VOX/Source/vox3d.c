@@ -53,7 +53,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 //void vmap_rgbg(fix x[4],fix y[4],fix dz[3],int near_ver,grs_bitmap *col,grs_bitmap *ht);
 //void vmap_poly(fix x[4],fix y[4],fix dz[3],int near_ver,grs_bitmap *col,grs_bitmap *ht);
-void vmap_dot(fix x0, fix y0, fix dxdu, fix dydu, fix dxdv, fix dydv, fix dxdz, fix dydz, int near_ver,vxs_vox *vx,int dotw,int doth,uchar clip);
 
 // The four vertices of every face
 //static int faces[6][4] = { {0,1,5,4},{1,2,6,5},{2,3,7,6}
@@ -278,7 +277,7 @@ void vx_render(vxs_vox *vx)
    //mprintf("clip = %d\n",clip);
    //mprintf("tmp[0]->gZ = %x\n",tmp[0]->gZ);
 
-   vmap_dot(a,b,tmp[1]->sx,tmp[1]->sy,tmp[2]->sx,tmp[2]->sy,tmp[3]->sx,tmp[3]->sy,near_ver,vx,fix_rint(psx),fix_rint(psy),clip);
+   vmap_dot_list(a,b,tmp[1]->sx,tmp[1]->sy,tmp[2]->sx,tmp[2]->sy,tmp[3]->sx,tmp[3]->sy,near_ver,vx,fix_rint(psx),fix_rint(psy),clip);
 
    g3_free_list(4,tmp);
 }
@@ -0,0 +1,264 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/*
+ * voxdots.c
+ *
+ * Cached dot lists for voxel objects
+ * This file is part of the vox library
+ *
+ * vmap_dot walks every texel of the color map each frame, skips the clear
+ * ones, and calls through the canvas table to set a color and draw a point
+ * or box for each of the rest.  Here the opaque texels of a color/height
+ * map pair are pulled out once, row by row, into separate column, height
+ * and color arrays that are kept between frames.  Each frame the screen
+ * spot of every dot is then one table lookup per axis, and the dots are
+ * written straight into the canvas in the same back to front order
+ * vmap_dot draws them in, so what ends up on screen is identical.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "2d.h"
+#include "res.h"
+#include "vox.h"
+
+extern fix *zdxdz;
+extern fix *zdydz;
+
+#ifdef DBG_ON
+extern int vxd_maxd;
+#endif
+
+// how many color/height map pairs we keep dot lists for
+#define VX_DOTS_CNT 8
+
+typedef struct {
+   uchar *col_bits;  // what this list was made from
+   uchar *ht_bits;
+   short w,h,crow,hrow;
+   uint32_t gen;     // resGeneration when made
+   uint last_use;
+   int n;            // number of opaque texels
+   int zmax;         // biggest height in the list
+   int *row;         // first dot of each row, h+1 of them
+   ushort *u;        // column of each dot
+   uchar *z;         // height of each dot
+   uchar *c;         // color of each dot
+   int *sx,*sy;      // screen spot of each dot, this frame
+   fix *ux,*uy;      // screen offset of each column, this frame
+   fix *vx,*vy;      // screen spot of each row, this frame
+} vxs_dots;
+
+static vxs_dots vx_dots[VX_DOTS_CNT];
+static uint vx_dots_clock;
+
+// Internal Prototypes
+static vxs_dots *vx_get_dots(grs_bitmap *col,grs_bitmap *ht);
+
+static vxs_dots *vx_get_dots(grs_bitmap *col,grs_bitmap *ht)
+{
+   vxs_dots *d,*use = NULL;
+   int i,j,n,zmax;
+   uchar *cp,*hp;
+   char *mem;
+
+   for (i=0;i<VX_DOTS_CNT;++i) {
+      d = &vx_dots[i];
+      if ((d->col_bits == col->bits) && (d->ht_bits == ht->bits) && (d->w == col->w) && (d->h == col->h)
+          && (d->crow == col->row) && (d->hrow == ht->row) && (d->gen == resGeneration)) {
+         d->last_use = ++vx_dots_clock;
+         return d;
+      }
+      if ((use == NULL) || (d->last_use < use->last_use))
+         use = d;
+   }
+
+   // count them first so it all fits in one block
+   n = 0;
+   for (j=0;j<col->h;++j) {
+      cp = col->bits + j*col->row;
+      for (i=0;i<col->w;++i)
+         if (cp[i] != 0) ++n;
+   }
+
+   free(use->row);
+   memset(use,0,sizeof(vxs_dots));
+   mem = (char *)malloc((col->h+1)*sizeof(int) + 2*n*sizeof(int) + 2*(col->w+col->h)*sizeof(fix)
+                        + n*sizeof(ushort) + 2*n);
+   if (mem == NULL)
+      return NULL;
+   use->row = (int *)mem;
+   use->sx = use->row + col->h + 1;
+   use->sy = use->sx + n;
+   use->ux = (fix *)(use->sy + n);
+   use->uy = use->ux + col->w;
+   use->vx = use->uy + col->w;
+   use->vy = use->vx + col->h;
+   use->u = (ushort *)(use->vy + col->h);
+   use->z = (uchar *)(use->u + n);
+   use->c = use->z + n;
+
+   n = zmax = 0;
+   for (j=0;j<col->h;++j) {
+      use->row[j] = n;
+      cp = col->bits + j*col->row;
+      hp = ht->bits + j*ht->row;
+      for (i=0;i<col->w;++i)
+         if (cp[i] != 0) {
+            use->u[n] = i;
+            use->z[n] = hp[i];
+            use->c[n++] = cp[i];
+            if (hp[i] > zmax) zmax = hp[i];
+         }
+   }
+   use->row[col->h] = n;
+
+   use->n = n;
+   use->zmax = zmax;
+   use->col_bits = col->bits;
+   use->ht_bits = ht->bits;
+   use->w = col->w;
+   use->h = col->h;
+   use->crow = col->row;
+   use->hrow = ht->row;
+   use->gen = resGeneration;
+   use->last_use = ++vx_dots_clock;
+   return use;
+}
+
+// Same arguments and same picture as vmap_dot, for flat 8 canvases in
+// normal fill mode with no clip stencil, the dots are only clipped to the
+// clip rectangle.  Anything else goes to vmap_dot.
+void vmap_dot_list(fix x0, fix y0, fix dxdu, fix dydu, fix dxdv, fix dydv, fix dxdz, fix dydz,
+                   int near_ver,vxs_vox *vx,int dotw,int doth,uchar clip)
+{
+   vxs_dots *d;
+   int i,j,k,kend,dk,initv,dv,endv;
+   int xl,xr,yt,yb,w,row;
+   short x,y;
+   fix xp,yp,bx,by;
+   uchar *bits,*p,c;
+
+   if ((grd_bm.type != BMT_FLAT8) || (gr_get_fill_type() != FILL_NORM) || (grd_clip.sten != NULL) ||
+       ((d = vx_get_dots(vx->col,vx->ht)) == NULL) || (d->zmax >= vx->d)) {
+      vmap_dot(x0,y0,dxdu,dydu,dxdv,dydv,dxdz,dydz,near_ver,vx,dotw,doth,clip);
+      return;
+   }
+
+   #ifdef DBG_ON
+   if (vx->d > vxd_maxd) {
+      mprintf("voxel object depth z=%d\n",vx->d);
+      mprintf("greater than max = %d\n",vxd_maxd);
+      return;
+   }
+   #endif
+
+   // tables so a dot is three lookups, not a multiply per axis
+   for (i=0;i<d->w;++i) {
+      d->ux[i] = dxdu*i;
+      d->uy[i] = dydu*i;
+   }
+   for (j=0;j<d->h;++j) {
+      d->vx[j] = x0 + dxdv*j;
+      d->vy[j] = y0 + dydv*j;
+   }
+   xp = yp = 0;
+   for (i=0;i<vx->d;++i) {
+      zdxdz[i] = xp;
+      zdydz[i] = yp;
+      xp += dxdz;
+      yp += dydz;
+   }
+
+   // every screen spot first, in the order the dots are stored
+   for (j=0;j<d->h;++j) {
+      bx = d->vx[j];
+      by = d->vy[j];
+      for (k=d->row[j];k<d->row[j+1];++k) {
+         d->sx[k] = (bx + d->ux[d->u[k]] + zdxdz[d->z[k]])>>16;
+         d->sy[k] = (by + d->uy[d->u[k]] + zdydz[d->z[k]])>>16;
+      }
+   }
+
+   // then draw them in the order vmap_dot would, far side first
+   if (near_ver < 2) {
+      initv = d->h-1;
+      dv = -1;
+      endv = -1;
+   }
+   else {
+      initv = 0;
+      dv = 1;
+      endv = d->h;
+   }
+   dk = (near_ver == 0 || near_ver == 3) ? -1 : 1;
+
+   bits = grd_bm.bits;
+   row = grd_bm.row;
+   for (j=initv;j!=endv;j+=dv) {
+      if (dk > 0) {
+         k = d->row[j];
+         kend = d->row[j+1];
+      }
+      else {
+         k = d->row[j+1]-1;
+         kend = d->row[j]-1;
+      }
+      for (;k!=kend;k+=dk) {
+         // vmap_dot hands these over as shorts
+         x = d->sx[k];
+         y = d->sy[k];
+         c = d->c[k];
+         if (doth>1) {
+            xl = x; xr = (short)(x+dotw);
+            yt = y; yb = (short)(y+doth);
+            if (clip) {
+               if (xl < grd_clip.left) xl = grd_clip.left;
+               if (xr > grd_clip.right) xr = grd_clip.right;
+               if (yt < grd_clip.top) yt = grd_clip.top;
+               if (yb > grd_clip.bot) yb = grd_clip.bot;
+            }
+            if ((xl >= xr) || (yt >= yb)) continue;
+            w = xr-xl;
+            p = bits+yt*row+xl;
+            if (w <= 8) {
+               // small ones are most of them, memset is all overhead at this size
+               for (;yt<yb;++yt,p+=row)
+                  for (i=0;i<w;++i) p[i] = c;
+            }
+            else
+               for (;yt<yb;++yt,p+=row)
+                  memset(p,c,w);
+         }
+         else if (!clip || ((x >= grd_clip.left) && (x < grd_clip.right) && (y >= grd_clip.top) && (y < grd_clip.bot)))
+            bits[y*row+x] = c;
+      }
+   }
+}
+
+// forget all the dot lists
+void vx_free_dots()
+{
+   int i;
+
+   for (i=0;i<VX_DOTS_CNT;++i) {
+      free(vx_dots[i].row);
+      memset(&vx_dots[i],0,sizeof(vxs_dots));
+   }
+}
@@ -67,6 +67,7 @@ uchar vx_init(int max_depth)
 
 void vx_close()
 {
+   vx_free_dots();
    free(zdxdz);
 }
 
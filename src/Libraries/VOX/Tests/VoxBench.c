@@ -0,0 +1,135 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+// times a voxel object drawn at a few sizes, texel by texel with vmap_dot and
+// from the kept dot list with vmap_dot_list, and checks they draw the same thing
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "2d.h"
+#include "vox.h"
+#include "bench.h"
+
+#define SCR_W 640
+#define SCR_H 480
+#define VOX_W 64
+#define VOX_H 64
+#define VOX_D 16 // VOXEL_DEPTH in gameobj.c
+#define PASSES 50
+
+static uchar screen[SCR_W * SCR_H], check[SCR_W * SCR_H];
+static uchar col_bits[VOX_W * VOX_H], ht_bits[VOX_W * VOX_H];
+static grs_bitmap col_bm, ht_bm, scr_bm;
+static grs_canvas can;
+static vxs_vox vox;
+
+// screen pixels per texel, and the size of each dot, far away to right up close
+static fix sizes[] = {fix_make(0, 0x8000), fix_make(1, 0), fix_make(2, 0), fix_make(4, 0), fix_make(7, 0)};
+#define SIZE_CNT (sizeof(sizes) / sizeof(sizes[0]))
+
+// a lumpy sort of dome, with a ring of clear texels around it like the game's
+static void make_vox(void) {
+    int x, y, dx, dy, r2;
+    for (y = 0; y < VOX_H; y++)
+        for (x = 0; x < VOX_W; x++) {
+            dx = x - VOX_W / 2;
+            dy = y - VOX_H / 2;
+            r2 = dx * dx + dy * dy;
+            if (r2 < (VOX_W / 2 - 2) * (VOX_W / 2 - 2)) {
+                col_bits[y * VOX_W + x] = 32 + (r2 + x) % 64;
+                ht_bits[y * VOX_W + x] = (VOX_D - 1) - (r2 * (VOX_D - 1)) / ((VOX_W / 2) * (VOX_W / 2)) - ((x ^ y) & 1);
+            } else
+                col_bits[y * VOX_W + x] = ht_bits[y * VOX_W + x] = 0;
+        }
+    gr_init_bm(&col_bm, col_bits, BMT_FLAT8, 0, VOX_W, VOX_H);
+    gr_init_bm(&ht_bm, ht_bits, BMT_FLAT8, 0, VOX_W, VOX_H);
+    vx_init_vox(&vox, fix_make(1, 0), fix_make(1, 0), VOX_D, &col_bm, &ht_bm);
+}
+
+// draw it at size s, turned a bit and tipped toward us, the way vx_render would hand it over
+static void draw(fix s, int near_ver, int list) {
+    fix dxdu = fix_mul(s, fix_make(0, 0xddb3)), dydu = fix_mul(s, fix_make(0, 0x4000));
+    fix dxdv = -fix_mul(s, fix_make(0, 0x2000)), dydv = fix_mul(s, fix_make(0, 0xb000));
+    fix dxdz = fix_mul(s, fix_make(0, 0x1000)), dydz = -fix_mul(s, fix_make(0, 0xc000));
+    fix x0 = fix_make(SCR_W / 2, 0) - ((VOX_W * dxdu + VOX_H * dxdv + VOX_D * dxdz) >> 1);
+    fix y0 = fix_make(SCR_H / 2, 0) - ((VOX_W * dydu + VOX_H * dydv + VOX_D * dydz) >> 1);
+    int dot = fix_rint(s) > 0 ? fix_rint(s) : 1;
+    uchar clip = (s >= fix_make(4, 0));
+
+    if (list)
+        vmap_dot_list(x0, y0, dxdu, dydu, dxdv, dydv, dxdz, dydz, near_ver, &vox, dot, dot, clip);
+    else
+        vmap_dot(x0, y0, dxdu, dydu, dxdv, dydv, dxdz, dydz, near_ver, &vox, dot, dot, clip);
+}
+
+typedef struct {
+    fix s;
+    int list;
+} draw_args;
+
+static void clear_screen(void *data) { memset(screen, 0xff, sizeof(screen)); }
+
+static void draw_passes(void *data) {
+    draw_args *a = (draw_args *)data;
+    int k;
+    for (k = 0; k < bench_passes; k++)
+        draw(a->s, k & 3, a->list);
+}
+
+static double time_draw(fix s, int list) {
+    draw_args a = {s, list};
+    return bench_time(clear_screen, draw_passes, &a);
+}
+
+int main(int argc, char *argv[]) {
+    int i, k, bad = 0;
+    double old_ms, new_ms;
+
+    bench_args(argc, argv, PASSES);
+    gr_init();
+    gr_init_bm(&scr_bm, screen, BMT_FLAT8, 0, SCR_W, SCR_H);
+    gr_make_canvas(&scr_bm, &can);
+    gr_set_canvas(&can);
+    vx_init(VOX_D);
+    make_vox();
+
+    printf("%dx%dx%d voxel object, %d draws each\n", VOX_W, VOX_H, VOX_D, bench_passes);
+    for (i = 0; i < SIZE_CNT; i++) {
+        old_ms = time_draw(sizes[i], FALSE);
+        new_ms = time_draw(sizes[i], TRUE);
+        printf("%5.2f px/texel   vmap_dot %8.2fms   vmap_dot_list %8.2fms   x%.2f\n", fix_float(sizes[i]), old_ms,
+               new_ms, old_ms / new_ms);
+
+        // every scan order against the texel at a time version
+        for (k = 0; k < 4; k++) {
+            memset(check, 0xff, sizeof(check));
+            memset(screen, 0xff, sizeof(screen));
+            draw(sizes[i], k, TRUE);
+            memcpy(check, screen, sizeof(check));
+            memset(screen, 0xff, sizeof(screen));
+            draw(sizes[i], k, FALSE);
+            bad |= bench_differ(screen, check, sizeof(check), "near_ver %d: vmap_dot and vmap_dot_list disagree!",
+                                k);
+        }
+    }
+
+    vx_close();
+    return bad;
+}
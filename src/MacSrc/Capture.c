@@ -0,0 +1,299 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+ 
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ 
+*/
+//====================================================================================
+//
+//		Capture.c	-	Records the presented frames, on a thread of its own.
+//
+//	SDLDraw hands every frame it shows to CaptureFrame, which copies the 8 bit
+//	pixels and the palette into the next free slot of a ring and moves on.  The
+//	ring has one writer and one reader, so the two ends are just a pair of
+//	counters, and nobody ever waits on a lock.  A worker thread takes frames off
+//	the other end and writes them out.  If the worker falls a whole ring behind,
+//	frames are dropped rather than holding up the game, and counted.
+//
+//	The raw format is a "SSCAPTUR" header and then, per frame, a frame number,
+//	the time it was shown in microseconds, its width and height (all little
+//	endian 32 bits), 768 bytes of RGB palette and the pixels, row by row.
+//
+//====================================================================================
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <SDL.h>
+
+#include "lg.h"
+#include "Capture.h"
+
+//--------------------
+//  Defines
+//--------------------
+#define CAPTURE_SLOTS		32
+#define CAPTURE_REPORT_SECS	10
+
+//--------------------
+//  Types
+//--------------------
+typedef struct {
+	uchar*	bits;
+	int		size;			// bytes allocated for bits
+	int		w, h;
+	Uint32	frame;
+	Uint64	when;			// performance counter when it was shown
+	uchar	pal[768];
+} CaptureSlot;
+
+//--------------------
+//  Globals
+//--------------------
+static CaptureSlot		slots[CAPTURE_SLOTS];
+static SDL_atomic_t		slotHead;		// next slot CaptureFrame fills, only it writes this
+static SDL_atomic_t		slotTail;		// next slot the worker writes out, only it writes this
+static SDL_atomic_t		workerRun;
+static SDL_atomic_t		framesWritten, lagSumMs, lagMaxMs;
+static SDL_Thread*		worker;
+static int				captureFormat = CAPTURE_OFF;
+static char				capturePath[512];
+static FILE*			rawFile;
+static Uint32			frameCount, framesDropped, framesDroppedReported;
+static Uint64			lastReport;
+
+//--------------------
+//  Prototypes
+//--------------------
+static void Put32(uchar* p, Uint32 v);
+static void WriteRaw(CaptureSlot* s);
+static void WriteBMP(CaptureSlot* s);
+static int CaptureWorker(void* data);
+static void CaptureReport(void);
+
+static void Put32(uchar* p, Uint32 v)
+{
+	p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static void WriteRaw(CaptureSlot* s)
+{
+	uchar head[20];
+	Uint64 us = s->when * 1000000 / SDL_GetPerformanceFrequency();
+
+	Put32(head, s->frame);
+	Put32(head + 4, (Uint32)us);
+	Put32(head + 8, (Uint32)(us >> 32));
+	Put32(head + 12, s->w);
+	Put32(head + 16, s->h);
+	fwrite(head, 1, sizeof(head), rawFile);
+	fwrite(s->pal, 1, sizeof(s->pal), rawFile);
+	fwrite(s->bits, 1, s->w * s->h, rawFile);
+}
+
+// an uncompressed 8 bit .bmp, which is bottom up, with rows padded to 4 bytes
+static void WriteBMP(CaptureSlot* s)
+{
+	uchar head[54 + 1024], pad[4] = {0, 0, 0, 0};
+	int row = (s->w + 3) & ~3, i, y;
+	char name[600];
+	FILE* f;
+
+	snprintf(name, sizeof(name), "%s-%06u.bmp", capturePath, s->frame);
+	if ((f = fopen(name, "wb")) == NULL)
+		return;
+	memset(head, 0, sizeof(head));
+	head[0] = 'B'; head[1] = 'M';
+	Put32(head + 2, sizeof(head) + row * s->h);
+	Put32(head + 10, sizeof(head));
+	Put32(head + 14, 40);
+	Put32(head + 18, s->w);
+	Put32(head + 22, s->h);
+	head[26] = 1;		// planes
+	head[28] = 8;		// bits per pixel
+	Put32(head + 34, row * s->h);
+	Put32(head + 46, 256);
+	for (i = 0; i < 256; i++) {
+		head[54 + i * 4] = s->pal[i * 3 + 2];
+		head[54 + i * 4 + 1] = s->pal[i * 3 + 1];
+		head[54 + i * 4 + 2] = s->pal[i * 3];
+	}
+	fwrite(head, 1, sizeof(head), f);
+	for (y = s->h - 1; y >= 0; y--) {
+		fwrite(s->bits + y * s->w, 1, s->w, f);
+		fwrite(pad, 1, row - s->w, f);
+	}
+	fclose(f);
+}
+
+static int CaptureWorker(void* data)
+{
+	CaptureSlot* s;
+	int t, lag, max;
+
+	for (;;) {
+		t = SDL_AtomicGet(&slotTail);
+		if (t == SDL_AtomicGet(&slotHead)) {
+			if (!SDL_AtomicGet(&workerRun))
+				break;		// all written, and no more coming
+			SDL_Delay(2);
+			continue;
+		}
+		SDL_MemoryBarrierAcquire();		// see the slot as CaptureFrame left it before it moved head
+		s = &slots[t % CAPTURE_SLOTS];
+		if (captureFormat == CAPTURE_RAW)
+			WriteRaw(s);
+		else
+			WriteBMP(s);
+
+		lag = (int)((SDL_GetPerformanceCounter() - s->when) * 1000 / SDL_GetPerformanceFrequency());
+		SDL_AtomicAdd(&lagSumMs, lag);
+		// CaptureReport may zero it between our look and our store, so only store over what we looked at
+		do {
+			max = SDL_AtomicGet(&lagMaxMs);
+		} while ((lag > max) && !SDL_AtomicCAS(&lagMaxMs, max, lag));
+		SDL_AtomicAdd(&framesWritten, 1);
+		SDL_MemoryBarrierRelease();		// done reading the slot before it's handed back
+		SDL_AtomicSet(&slotTail, t + 1);
+	}
+	return 0;
+}
+
+// how it's going, every so often and at the end
+static void CaptureReport(void)
+{
+	int written = SDL_AtomicGet(&framesWritten);
+	int queued = SDL_AtomicGet(&slotHead) - SDL_AtomicGet(&slotTail);
+	int max = SDL_AtomicSet(&lagMaxMs, 0);		// read and start over in one go, the worker keeps raising it
+
+	INFO("Capture: %u frames shown, %d written, %u dropped (%u since last), %d queued, writer lag %dms avg %dms max",
+	     frameCount, written, framesDropped, framesDropped - framesDroppedReported, queued,
+	     written ? SDL_AtomicGet(&lagSumMs) / written : 0, max);
+	framesDroppedReported = framesDropped;
+}
+
+void CaptureStart(int format)
+{
+	char* p;
+
+	if (captureFormat != CAPTURE_OFF)
+		CaptureStop();
+	if (format != CAPTURE_RAW && format != CAPTURE_BMP)
+		return;
+
+	p = SDL_GetPrefPath("Interrupt", "SystemShock");
+	snprintf(capturePath, sizeof(capturePath), "%scapture-%ld", p ? p : "", (long)time(NULL));
+	free(p);
+	if (format == CAPTURE_RAW) {
+		char name[600];
+		snprintf(name, sizeof(name), "%s.raw", capturePath);
+		if ((rawFile = fopen(name, "wb")) == NULL) {
+			ERROR("Capture: can't open %s", name);
+			return;
+		}
+		fwrite("SSCAPTUR", 1, 8, rawFile);
+	}
+
+	SDL_AtomicSet(&slotHead, 0);
+	SDL_AtomicSet(&slotTail, 0);
+	SDL_AtomicSet(&framesWritten, 0);
+	SDL_AtomicSet(&lagSumMs, 0);
+	SDL_AtomicSet(&lagMaxMs, 0);
+	SDL_AtomicSet(&workerRun, 1);
+	frameCount = framesDropped = framesDroppedReported = 0;
+	lastReport = SDL_GetPerformanceCounter();
+	captureFormat = format;
+
+	worker = SDL_CreateThread(CaptureWorker, "CaptureWorker", NULL);
+	if (worker == NULL) {
+		ERROR("Capture: can't start the writer thread");
+		if (rawFile) { fclose(rawFile); rawFile = NULL; }
+		captureFormat = CAPTURE_OFF;
+		return;
+	}
+	INFO("Capture: recording to %s%s", capturePath, (format == CAPTURE_RAW) ? ".raw" : "-*.bmp");
+}
+
+// let the worker finish what's queued, then close up
+void CaptureStop(void)
+{
+	int i;
+
+	if (captureFormat == CAPTURE_OFF)
+		return;
+	SDL_AtomicSet(&workerRun, 0);
+	SDL_WaitThread(worker, NULL);
+	worker = NULL;
+	CaptureReport();
+	if (rawFile) { fclose(rawFile); rawFile = NULL; }
+	for (i = 0; i < CAPTURE_SLOTS; i++) {
+		free(slots[i].bits);
+		slots[i].bits = NULL;
+		slots[i].size = 0;
+	}
+	captureFormat = CAPTURE_OFF;
+}
+
+// Called with each frame as it's shown.  Copies it into the ring, or drops it
+// if the ring is full, and never waits.
+void CaptureFrame(uchar* bits, int row, int w, int h, SDL_Color* pal)
+{
+	CaptureSlot* s;
+	int head, i, y;
+	Uint64 now;
+
+	if (captureFormat == CAPTURE_OFF)
+		return;
+	frameCount++;
+	now = SDL_GetPerformanceCounter();
+	if (now - lastReport >= CAPTURE_REPORT_SECS * SDL_GetPerformanceFrequency()) {
+		CaptureReport();
+		lastReport = now;
+	}
+
+	head = SDL_AtomicGet(&slotHead);
+	if (head - SDL_AtomicGet(&slotTail) >= CAPTURE_SLOTS) {
+		framesDropped++;
+		return;
+	}
+	SDL_MemoryBarrierAcquire();
+
+	// the worker is done with this one, it's ours until head moves past it
+	s = &slots[head % CAPTURE_SLOTS];
+	if (s->size < w * h) {
+		free(s->bits);
+		s->bits = (uchar*)malloc(w * h);
+		s->size = (s->bits != NULL) ? w * h : 0;
+		if (s->bits == NULL) {
+			framesDropped++;
+			return;
+		}
+	}
+	for (y = 0; y < h; y++)
+		memcpy(s->bits + y * w, bits + y * row, w);
+	for (i = 0; i < 256; i++) {
+		s->pal[i * 3] = pal[i].r;
+		s->pal[i * 3 + 1] = pal[i].g;
+		s->pal[i * 3 + 2] = pal[i].b;
+	}
+	s->w = w;
+	s->h = h;
+	s->frame = frameCount;
+	s->when = now;
+	SDL_MemoryBarrierRelease();		// the slot has to be all there before the worker can see it
+	SDL_AtomicSet(&slotHead, head + 1);
+}
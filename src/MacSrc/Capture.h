@@ -0,0 +1,44 @@
+/*
+
+Copyright (C) 2015-2018 Night Dive Studios, LLC.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+ 
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+ 
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ 
+*/
+//====================================================================================
+//
+//		Capture.h	-	Records the presented frames, on a thread of its own.
+//
+//====================================================================================
+
+#ifndef __CAPTURE_H
+#define __CAPTURE_H
+
+#include <SDL.h>
+
+//--------------------
+//  Defines
+//--------------------
+#define CAPTURE_OFF		0
+#define CAPTURE_RAW		1	// one file, every frame with its palette
+#define CAPTURE_BMP		2	// an 8 bit .bmp for every frame
+
+//--------------------
+//  Prototypes
+//--------------------
+void CaptureStart(int format);
+void CaptureStop(void);
+void CaptureFrame(uchar *bits, int row, int w, int h, SDL_Color *pal);
+
+#endif
@@ -37,6 +37,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "input.h"
 #include "mainloop.h"
 #include "movekeys.h"
+#include "autodet.h"
+#include "framelim.h"
+#include "textmaps.h"
+#include "view360.h"
 
 //--------------------
 //  Filenames
@@ -76,6 +80,15 @@ static const char *PREF_HALFRES      = "half-resolution";
 static const char *PREF_DETAIL       = "detail";
 static const char *PREF_USE_OPENGL   = "use-opengl";
 static const char *PREF_TEX_FILTER   = "texture-filter";
+static const char *PREF_TEX_CACHE    = "texture-cache";
+static const char *PREF_FRAME_BUDGET = "frame-budget";
+static const char *PREF_ADAPT_HALF   = "adaptive-halfres";
+static const char *PREF_FRAME_CAP    = "frame-cap";
+static const char *PREF_IDLE_CAP     = "idle-frame-cap";
+static const char *PREF_FRAME_STATS  = "frame-stats";
+static const char *PREF_OUT_SCALER   = "output-scaler";
+static const char *PREF_STAGGER_360  = "stagger-360-views";
+static const char *PREF_CAPTURE      = "capture";
 static const char *PREF_ONSCR_HELP   = "onscreen-help";
 static const char *PREF_GAMMA        = "gamma";
 static const char *PREF_MSG_LENGTH   = "message-length";
@@ -116,6 +129,15 @@ void SetDefaultPrefs(void) {
     gShockPrefs.doDetail = 3;           // Max detail.
     gShockPrefs.doUseOpenGL = false;
     gShockPrefs.doTextureFilter = 0;      // unfiltered
+    gShockPrefs.doTextureCache = TMAP_BIG_DEFAULT;
+    gShockPrefs.doFrameBudget = 0;        // fixed detail
+    gShockPrefs.doAdaptHalfRes = false;
+    gShockPrefs.doFrameCap = 0;           // uncapped
+    gShockPrefs.doIdleFrameCap = 15;
+    gShockPrefs.doFrameStats = false;
+    gShockPrefs.doOutputScaler = 0;       // leave it to SDL
+    gShockPrefs.doStagger360 = true;      // each side view at a third of the frame rate
+    gShockPrefs.doCapture = 0;            // not recording
     gShockPrefs.goOnScreenHelp = true;
     gShockPrefs.doGamma = 29;           // Default gamma (29 out of 100).
     gShockPrefs.goMsgLength = 0;        // Normal
@@ -216,6 +238,36 @@ OSErr LoadPrefs(void) {
             int mode = atoi(value);
             if (mode >= 0 && mode <= 1)
                 gShockPrefs.doTextureFilter = (short)mode;
+        } else if (strcasecmp(key, PREF_TEX_CACHE) == 0) {
+            int cnt = atoi(value);
+            if (cnt >= TMAP_BIG_MIN && cnt <= NUM_STATIC_TMAPS)
+                gShockPrefs.doTextureCache = (short)cnt;
+        } else if (strcasecmp(key, PREF_FRAME_BUDGET) == 0) {
+            int ms = atoi(value);
+            if (ms >= 0 && ms <= 1000)
+                gShockPrefs.doFrameBudget = (short)ms;
+        } else if (strcasecmp(key, PREF_ADAPT_HALF) == 0) {
+            gShockPrefs.doAdaptHalfRes = is_true(value);
+        } else if (strcasecmp(key, PREF_FRAME_CAP) == 0) {
+            int fps = atoi(value);
+            if (fps >= 0 && fps <= 1000)
+                gShockPrefs.doFrameCap = (short)fps;
+        } else if (strcasecmp(key, PREF_IDLE_CAP) == 0) {
+            int fps = atoi(value);
+            if (fps >= 0 && fps <= 1000)
+                gShockPrefs.doIdleFrameCap = (short)fps;
+        } else if (strcasecmp(key, PREF_FRAME_STATS) == 0) {
+            gShockPrefs.doFrameStats = is_true(value);
+        } else if (strcasecmp(key, PREF_STAGGER_360) == 0) {
+            gShockPrefs.doStagger360 = is_true(value);
+        } else if (strcasecmp(key, PREF_OUT_SCALER) == 0) {
+            int mode = atoi(value);
+            if (mode >= 0 && mode <= 2)
+                gShockPrefs.doOutputScaler = (short)mode;
+        } else if (strcasecmp(key, PREF_CAPTURE) == 0) {
+            int mode = atoi(value);
+            if (mode >= 0 && mode <= 2)
+                gShockPrefs.doCapture = (short)mode;
         } else if (strcasecmp(key, PREF_ONSCR_HELP) == 0) {
             gShockPrefs.goOnScreenHelp = is_true(value);
         } else if (strcasecmp(key, PREF_GAMMA) == 0) {
@@ -266,10 +318,19 @@ OSErr SavePrefs(void) {
     fprintf(f, "%s = %d\n", PREF_SFX_VOL, sfx_on ? curr_sfx_vol : 0);
     fprintf(f, "%s = %d\n", PREF_ALOG_VOL, curr_alog_vol);
     fprintf(f, "%s = %d\n", PREF_VIDEOMODE, mode_id);
-    fprintf(f, "%s = %s\n", PREF_HALFRES, DoubleSize ? "yes" : "no");
-    fprintf(f, "%s = %d\n", PREF_DETAIL, _fr_global_detail);
+    fprintf(f, "%s = %s\n", PREF_HALFRES, autodet_user_half_res() ? "yes" : "no");
+    fprintf(f, "%s = %d\n", PREF_DETAIL, autodet_user_detail());
     fprintf(f, "%s = %s\n", PREF_USE_OPENGL, gShockPrefs.doUseOpenGL ? "yes" : "no");
     fprintf(f, "%s = %d\n", PREF_TEX_FILTER, gShockPrefs.doTextureFilter);
+    fprintf(f, "%s = %d\n", PREF_TEX_CACHE, gShockPrefs.doTextureCache);
+    fprintf(f, "%s = %d\n", PREF_FRAME_BUDGET, gShockPrefs.doFrameBudget);
+    fprintf(f, "%s = %s\n", PREF_ADAPT_HALF, gShockPrefs.doAdaptHalfRes ? "yes" : "no");
+    fprintf(f, "%s = %d\n", PREF_FRAME_CAP, gShockPrefs.doFrameCap);
+    fprintf(f, "%s = %d\n", PREF_IDLE_CAP, gShockPrefs.doIdleFrameCap);
+    fprintf(f, "%s = %s\n", PREF_FRAME_STATS, gShockPrefs.doFrameStats ? "yes" : "no");
+    fprintf(f, "%s = %d\n", PREF_OUT_SCALER, gShockPrefs.doOutputScaler);
+    fprintf(f, "%s = %s\n", PREF_STAGGER_360, gShockPrefs.doStagger360 ? "yes" : "no");
+    fprintf(f, "%s = %d\n", PREF_CAPTURE, gShockPrefs.doCapture);
     fprintf(f, "%s = %s\n", PREF_ONSCR_HELP, gShockPrefs.goOnScreenHelp ? "yes" : "no");
     fprintf(f, "%s = %d\n", PREF_GAMMA, gShockPrefs.doGamma);
     fprintf(f, "%s = %d\n", PREF_MSG_LENGTH, gShockPrefs.goMsgLength);
@@ -297,6 +358,13 @@ static void SetShockGlobals(void) {
     DoubleSize = (gShockPrefs.doResolution == 1); // Set this True for low-res.
     SkipLines = gShockPrefs.doUseQD;
     _fr_global_detail = gShockPrefs.doDetail;
+    tmap_big_budget = gShockPrefs.doTextureCache;
+    autodet_budget = gShockPrefs.doFrameBudget;
+    autodet_half_res_ok = gShockPrefs.doAdaptHalfRes;
+    framelim_fps = gShockPrefs.doFrameCap;
+    framelim_idle_fps = gShockPrefs.doIdleFrameCap;
+    framelim_stats = gShockPrefs.doFrameStats;
+    view360_stagger = gShockPrefs.doStagger360;
 }
 
 //************************************************************************************
@@ -61,6 +61,21 @@ typedef struct {
     // 1 => bilinear
     // TODO: add trilinear, anisotropic?
     short doTextureFilter;
+    short doTextureCache;       // how many 128x128 textures to keep loaded
+    short doFrameBudget;        // ms for the 3d view, 0 - fixed detail
+    Boolean doAdaptHalfRes;     // adaptive detail may drop to low res
+    short doFrameCap;           // frames per second, 0 - uncapped
+    short doIdleFrameCap;       // same when unfocused or paused, 0 - no different
+    Boolean doFrameStats;       // log frame times now and then
+    Boolean doStagger360;       // with several 360 views up, render one a frame in turn
+    // 0 => let SDL stretch it
+    // 1 => integer nearest neighbour
+    // 2 => Scale2x
+    short doOutputScaler;
+    // 0 => off
+    // 1 => every frame shown, into one raw file
+    // 2 => every frame shown, as a .bmp each
+    short doCapture;
 } ShockPrefs;
 
 //--------------------
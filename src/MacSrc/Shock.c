@@ -35,6 +35,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Shock.h"
 #include "InitMac.h"
 #include "OpenGL.h"
+#include "Capture.h"
 #include "Prefs.h"
 #include "ShockBitmap.h"
 #include "ShockHelp.h"
@@ -274,6 +275,8 @@ void InitSDL()
 	// Create the palette
 
 	sdlPalette = SDL_AllocPalette(256);
+	SDL_SetSurfacePalette(drawSurface, sdlPalette);
+	SDL_SetSurfacePalette(offscreenDrawSurface, sdlPalette);
 
 	// Setup the screen
 
@@ -286,6 +289,10 @@ void InitSDL()
 
 	atexit(SDL_Quit);
 
+	// record what's shown, if asked; stopping it runs before SDL_Quit
+	CaptureStart(gShockPrefs.doCapture);
+	atexit(CaptureStop);
+
 	SDL_RaiseWindow(window);
 
 	renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_PRESENTVSYNC);
@@ -300,6 +307,24 @@ void InitSDL()
 
 SDL_Color gamePalette[256];
 bool UseCutscenePalette = FALSE; //see cutsloop.c
+
+// gamePalette as ARGB8888 for the screen texture, 255 see-through for the OpenGL overlay
+static uint32_t screenPalette[256];
+static SDL_Texture* screenTexture;
+static int screenTextureW, screenTextureH, screenTextureK;
+
+// what the screen texture was last filled from, so only what changed gets sent
+#define SCREEN_DIRTY_MAX 8
+#define SCREEN_PAL_ALL 128 // this many colors changed is as good as all of them
+static uchar* screenLast;
+static bool screenAllDirty = TRUE;
+static int screenPalLo = 256, screenPalHi = -1; // colors changed since, too
+
+// time spent filling the screen texture, reported with the frame stats
+#define SCREEN_REPORT_SECS 10
+static Uint64 screenFillTime, screenReportStart;
+static int screenFillFrames;
+
 void SetSDLPalette(int index, int count, uchar *pal)
 {
   static bool gammalut_init = 0;
@@ -327,44 +352,201 @@ void SetSDLPalette(int index, int count, uchar *pal)
   if (gam > 100) gam = 100;
   gam -= 10;
 
+  // the palette effects set the whole palette every step, when only a few
+  // colors (or none) moved; keep track of which did
+  int lo = 256, hi = -1;
+  SDL_Color c;
+
   for (int i = index; i < index+count; i++)
   {
-    gamePalette[i].r = gammalut[gam][*pal++];
-    gamePalette[i].g = gammalut[gam][*pal++];
-    gamePalette[i].b = gammalut[gam][*pal++];
-    gamePalette[i].a = 0xff;
+    c.r = gammalut[gam][*pal++];
+    c.g = gammalut[gam][*pal++];
+    c.b = gammalut[gam][*pal++];
+    c.a = 0xff;
+    if (i == 255 && !UseCutscenePalette)
+      continue;
+    if (memcmp(&c, &gamePalette[i], sizeof(c)) != 0)
+    {
+      gamePalette[i] = c;
+      if (i < lo) lo = i;
+      hi = i;
+    }
   }
 
   if (!UseCutscenePalette)
   {
     // Hack black!
-    gamePalette[255].r = 0x0;
-    gamePalette[255].g = 0x0;
-    gamePalette[255].b = 0x0;
-    gamePalette[255].a = 0xff;
+    c.r = c.g = c.b = 0x0;
+    c.a = 0xff;
+    if (memcmp(&c, &gamePalette[255], sizeof(c)) != 0)
+    {
+      gamePalette[255] = c;
+      if (lo > 255) lo = 255;
+      hi = 255;
+    }
   }
 
-  SDL_SetPaletteColors(sdlPalette, gamePalette, 0, 256);
-  SDL_SetSurfacePalette(drawSurface, sdlPalette);
-  SDL_SetSurfacePalette(offscreenDrawSurface, sdlPalette);
+  if (lo > hi)
+    return;
+
+  for (int i = lo; i <= hi; i++)
+    screenPalette[i] = (0xff << 24) | (gamePalette[i].r << 16) | (gamePalette[i].g << 8) | gamePalette[i].b;
+  screenPalette[255] &= 0x00ffffff;
+  if (lo < screenPalLo) screenPalLo = lo;
+  if (hi > screenPalHi) screenPalHi = hi;
+
+  // the surfaces share sdlPalette, SetupOffscreenBitmaps hands it to them
+  SDL_SetPaletteColors(sdlPalette, &gamePalette[lo], lo, hi - lo + 1);
 
   if (should_opengl_swap())
     opengl_change_palette();
 }
 
-void SDLDraw()
+// How much to scale the screen up by on the way into the texture.  The
+// renderer stretches whatever is left to fit the window.
+static int GetScreenScale(void)
 {
-	sdlPalette->colors[255].a = 0x00;
-	SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, drawSurface);
-	sdlPalette->colors[255].a = 0xff;
+	int w, h, k;
+
+	switch (gShockPrefs.doOutputScaler) {
+	case 1:
+		if (SDL_GetRendererOutputSize(renderer, &w, &h) != 0)
+			return 1;
+		k = (w / drawSurface->w < h / drawSurface->h) ? w / drawSurface->w : h / drawSurface->h;
+		return (k < 1) ? 1 : (k > 4) ? 4 : k;
+	case 2:
+		return 2;
+	}
+	return 1;
+}
 
-	if (should_opengl_swap()) {
-		SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+// Keep one streaming texture the size of the draw surface, times the scale,
+// and each frame expand the 8 bit pixels that changed straight into it
+// through screenPalette.
+static SDL_Texture* GetScreenTexture(int k)
+{
+	if (screenTexture != NULL && screenTextureW == drawSurface->w && screenTextureH == drawSurface->h &&
+	    screenTextureK == k)
+		return screenTexture;
+
+	if (screenTexture != NULL)
+		SDL_DestroyTexture(screenTexture);
+	screenTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+	                                  drawSurface->w * k, drawSurface->h * k);
+	if (screenTexture == NULL) {
+		ERROR("SDL: Failed to create screen texture: %s", SDL_GetError());
+		return NULL;
 	}
+	screenTextureW = drawSurface->w;
+	screenTextureH = drawSurface->h;
+	screenTextureK = k;
+
+	free(screenLast);
+	screenLast = (uchar*)malloc(drawSurface->pitch * drawSurface->h);
+	screenAllDirty = TRUE;
+	return screenTexture;
+}
 
-	SDL_Rect srcRect = { 0, 0, gScreenWide, gScreenHigh };
-	SDL_RenderCopy(renderer, texture, &srcRect, NULL);
-	SDL_DestroyTexture(texture);
+static void ReportScreenFill(Uint64 start)
+{
+	static const char* names[] = { "none", "nearest", "scale2x" };
+	Uint64 now = SDL_GetPerformanceCounter();
+	int us;
+
+	if (!gShockPrefs.doFrameStats)
+		return;
+	screenFillTime += now - start;
+	screenFillFrames++;
+	if (screenReportStart == 0)
+		screenReportStart = now;
+	if (now - screenReportStart >= SCREEN_REPORT_SECS * SDL_GetPerformanceFrequency()) {
+		us = (int)(screenFillTime * 1000000 / SDL_GetPerformanceFrequency() / screenFillFrames);
+		INFO("Screen texture fill: %d.%03dms per frame, scaler %s x%d", us / 1000, us % 1000,
+		     names[gShockPrefs.doOutputScaler], screenTextureK);
+		screenFillTime = 0;
+		screenFillFrames = 0;
+		screenReportStart = now;
+	}
+}
+
+void SDLDraw()
+{
+	int k = GetScreenScale();
+	SDL_Texture* texture = GetScreenTexture(k);
+	grs_rect dirty[2 * SCREEN_DIRTY_MAX];
+	uchar* bits = drawSurface->pixels;
+	int row = drawSurface->pitch;
+	int i, n = 0;
+	void* pixels;
+	int pitch;
+	Uint64 start = SDL_GetPerformanceCounter();
+
+	if (texture != NULL) {
+		// a fade changes every color, so it's all of the screen anyway
+		if (screenAllDirty || screenLast == NULL || screenPalHi - screenPalLo >= SCREEN_PAL_ALL) {
+			dirty[0].left = dirty[0].top = 0;
+			dirty[0].right = drawSurface->w;
+			dirty[0].bot = drawSurface->h;
+			n = 1;
+		} else {
+			n = gr_dirty_find(bits, screenLast, row, drawSurface->w, drawSurface->h, dirty, SCREEN_DIRTY_MAX);
+			// and wherever the colors that changed are, when they're just cycling
+			n += gr_dirty_find_pal(bits, row, drawSurface->w, drawSurface->h, screenPalLo, screenPalHi, dirty + n,
+			                       SCREEN_DIRTY_MAX);
+		}
+		screenPalLo = 256;
+		screenPalHi = -1;
+
+		for (i = 0; i < n; i++) {
+			SDL_Rect r = { dirty[i].left, dirty[i].top, dirty[i].right - dirty[i].left, dirty[i].bot - dirty[i].top };
+			if (gShockPrefs.doOutputScaler == 2) {
+				// a pixel's neighbours change what it scales to
+				if (r.x > 0) { r.x--; r.w++; }
+				if (r.y > 0) { r.y--; r.h++; }
+				if (r.x + r.w < drawSurface->w) r.w++;
+				if (r.y + r.h < drawSurface->h) r.h++;
+			}
+			SDL_Rect tr = { r.x * k, r.y * k, r.w * k, r.h * k };
+			if (SDL_LockTexture(texture, &tr, &pixels, &pitch) != 0)
+				break;
+			if (gShockPrefs.doOutputScaler == 2)
+				gr_flat8_to_argb_scale2x(pixels, pitch, bits, row, drawSurface->w, drawSurface->h, r.x, r.y, r.w, r.h,
+				                         screenPalette);
+			else
+				gr_flat8_to_argb_scale(pixels, pitch, bits + r.y * row + r.x, row, r.w, r.h, screenPalette, k);
+			SDL_UnlockTexture(texture);
+		}
+		if (i < n)
+			texture = NULL; // start again from scratch next frame
+		else if (screenLast != NULL) {
+			gr_dirty_keep(bits, screenLast, row, dirty, n);
+			screenAllDirty = FALSE;
+		}
+	}
+
+	CaptureFrame(bits, row, gScreenWide, gScreenHigh, gamePalette);
+
+	if (texture != NULL) {
+		ReportScreenFill(start);
+		SDL_SetTextureBlendMode(texture, should_opengl_swap() ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+
+		SDL_Rect srcRect = { 0, 0, gScreenWide * k, gScreenHigh * k };
+		SDL_RenderCopy(renderer, texture, &srcRect, NULL);
+	} else {
+		// no streaming texture, so convert the surface the slow way
+		screenAllDirty = TRUE;
+		sdlPalette->colors[255].a = 0x00;
+		texture = SDL_CreateTextureFromSurface(renderer, drawSurface);
+		sdlPalette->colors[255].a = 0xff;
+
+		if (should_opengl_swap()) {
+			SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+		}
+
+		SDL_Rect srcRect = { 0, 0, gScreenWide, gScreenHigh };
+		SDL_RenderCopy(renderer, texture, &srcRect, NULL);
+		SDL_DestroyTexture(texture);
+	}
 
 	if (should_opengl_swap()) {
 		opengl_swap_and_restore();
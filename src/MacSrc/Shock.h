@@ -180,6 +180,7 @@ extern short				gBarkVref;
 
 extern grs_screen  *cit_screen;
 extern SDL_Window* window;
+extern SDL_Palette* sdlPalette;
 
 
 /*#else
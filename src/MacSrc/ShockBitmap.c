@@ -78,6 +78,13 @@ void SetupOffscreenBitmaps(int width, int height)
 		return;
 	}
 
+	// new surfaces come with a palette of their own, and SetSDLPalette only
+	// touches it when a color changes
+	if (sdlPalette != NULL) {
+		SDL_SetSurfacePalette(drawSurface, sdlPalette);
+		SDL_SetSurfacePalette(offscreenDrawSurface, sdlPalette);
+	}
+
     // Point the renderer at the screen bytes
 	gScreenRowbytes = drawSurface->w;
 	gScreenAddress = drawSurface->pixels;